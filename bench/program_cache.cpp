@@ -0,0 +1,79 @@
+#include <small_gl/program.hpp>
+#include <small_gl/window.hpp>
+#include <fmt/core.h>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Benchmark of gl::ProgramCache save/load/prefetch over a batch of generated compute shaders;
+// usage: bench_program_cache [n_programs]
+int main(int argc, char **argv) {
+  using namespace gl;
+  using clock = std::chrono::steady_clock;
+  using ms    = std::chrono::duration<float, std::milli>;
+
+  const uint n_programs = argc > 1 ? static_cast<uint>(std::atoi(argv[1])) : 256u;
+
+  // Hidden window, only to obtain a context
+  Window window({ .size = { 1, 1 }, .title = "bench_program_cache", .swap_interval = 0,
+                     .profile_type = ProfileType::eCore, 
+                     .profile_version_major = 4, .profile_version_minor = 6 });
+
+  // Generate distinct compute shaders in a scratch directory
+  fs::path dir        = fs::temp_directory_path() / "small_gl_bench_program_cache";
+  fs::path cache_path = dir / "cache.bin";
+  fs::create_directories(dir);
+  std::vector<ShaderLoadFileInfo> info(n_programs);
+  for (uint i = 0; i < n_programs; ++i) {
+    fs::path path = dir / fmt::format("shader_{}.comp", i);
+    std::ofstream(path) << fmt::format(
+      "#version 460 core\n"
+      "layout(local_size_x = 64) in;\n"
+      "layout(binding = 0, std430) buffer b_data {{ float data[]; }};\n"
+      "void main() {{\n"
+      "  uint i = gl_GlobalInvocationID.x;\n"
+      "  for (uint j = 0; j < {}; ++j) data[i] = sin(data[i] * {}.0 + float(j));\n"
+      "}}\n", 4 + i % 16, i + 1);
+    info[i] = { .type = ShaderType::eCompute, .glsl_path = path };
+  }
+
+  // Cold compile, then save
+  ProgramCache cache;
+  auto t_compile = clock::now();
+  for (auto &i : info)
+    cache.set(ShaderLoadFileInfo(i));
+  auto t_save = clock::now();
+  cache.save(cache_path);
+  auto t_end = clock::now();
+  fmt::print("compile  : {:8.2f} ms\n", ms(t_save - t_compile).count());
+  fmt::print("save     : {:8.2f} ms ({} bytes)\n", ms(t_end - t_save).count(), fs::file_size(cache_path));
+
+  // Lazy load; entries are instantiated on first use
+  {
+    ProgramCache cache;
+    auto t_load = clock::now();
+    cache.load(cache_path);
+    auto t_use = clock::now();
+    for (auto &i : info)
+      cache.set(ShaderLoadFileInfo(i));
+    auto t_end = clock::now();
+    fmt::print("load     : {:8.2f} ms\n", ms(t_use - t_load).count());
+    fmt::print("first use: {:8.2f} ms\n", ms(t_end - t_use).count());
+  }
+
+  // Eager load; entries are decompressed in parallel
+  {
+    ProgramCache cache;
+    auto t_load = clock::now();
+    cache.load(cache_path);
+    cache.prefetch();
+    auto t_end = clock::now();
+    fmt::print("prefetch : {:8.2f} ms\n", ms(t_end - t_load).count());
+  }
+
+  fs::remove_all(dir);
+  return 0;
+}
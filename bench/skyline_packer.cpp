@@ -0,0 +1,52 @@
+#include <small_gl/detail/skyline_packer.hpp>
+#include <fmt/core.h>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// Benchmark of gl::detail::SkylinePacker; packs random rectangles of several size
+// distributions until the area is full, and reports throughput and occupancy. CPU only;
+// usage: bench_skyline_packer [area_size]
+int main(int argc, char **argv) {
+  using namespace gl;
+  using clock = std::chrono::steady_clock;
+  using ms    = std::chrono::duration<float, std::milli>;
+
+  const uint area_size = argc > 1 ? static_cast<uint>(std::atoi(argv[1])) : 4096u;
+  
+  // Size distributions, as { min, max } rectangle sides
+  struct RangeData { const char *name; uint min, max; };
+  const std::vector<RangeData> ranges = {{ "glyphs",  8,   48  },
+                                         { "icons",   16,  128 },
+                                         { "sprites", 32,  512 },
+                                         { "mixed",   4,   768 }};
+
+  for (const auto &range : ranges) {
+    std::mt19937 rng(1337);
+    std::uniform_int_distribution<uint> dist(range.min, range.max);
+    std::vector<eig::Array2u> sizes(1u << 20);
+    for (auto &size : sizes)
+      size = { dist(rng), dist(rng) };
+
+    // Insert until a run of consecutive failures, so smaller rectangles may fill remaining gaps
+    detail::SkylinePacker packer({ area_size, area_size });
+    size_t n_inserted = 0, n_failed = 0;
+    auto t_begin = clock::now();
+    for (const auto &size : sizes) {
+      if (packer.insert(size)) {
+        n_inserted++;
+        n_failed = 0;
+      } else {
+        guard_break(++n_failed < 256);
+      }
+    }
+    auto t_end = clock::now();
+
+    float time = ms(t_end - t_begin).count();
+    fmt::print("{:8} : {:7} rects in {:8.2f} ms, occupancy {:5.1f}%\n", 
+               range.name, n_inserted, time, 100.f * packer.occupancy());
+  }
+
+  return 0;
+}
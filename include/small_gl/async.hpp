@@ -0,0 +1,205 @@
+#pragma once
+
+#include <small_gl/fwd.hpp>
+#include <small_gl/enum.hpp>
+#include <small_gl/buffer.hpp>
+#include <small_gl/program.hpp>
+#include <small_gl/texture.hpp>
+#include <small_gl/utility.hpp>
+#include <small_gl/window.hpp>
+#include <small_gl/detail/trace.hpp>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace gl {
+  /**
+   * Helper object to create async worker object.
+   */
+  struct AsyncWorkerInfo {
+    // Main context with which the worker's hidden context shares objects
+    const Window *shared_context = nullptr;
+
+    // Worker context settings; should generally match the main context
+    ProfileType profile_type     = ProfileType::eAny;
+    uint profile_version_major   = 1;
+    uint profile_version_minor   = 0;
+    bool is_debug_context        = false;
+  };
+
+  /**
+   * Handle to the result of a job submitted to gl::AsyncWorker. The produced
+   * object becomes available once the job has run on the worker; it is safe to
+   * use on the main context once the accompanying fence signals.
+   */
+  template <typename T>
+  class AsyncResult {
+    using DataType = std::pair<T, sync::Fence>;
+
+    std::future<DataType>   m_future;
+    std::optional<DataType> m_data;
+
+    // Obtain job output from future; blocks if the job has not yet run
+    void fetch() {
+      if (!m_data)
+        m_data = m_future.get();
+    }
+
+  public:
+    /* constr/destr */
+
+    AsyncResult() = default;
+    AsyncResult(std::future<DataType> &&future)
+    : m_future(std::move(future)) { }
+
+    /* getters */
+
+    inline bool is_valid() const { return m_data.has_value() || m_future.valid(); }
+
+    // Test if the job has run and its gpu work has completed, without blocking
+    bool is_ready() {
+      gl_trace();
+      guard(!m_data.has_value(), m_data->second.is_signalled());
+      guard(m_future.valid(), false);
+      guard(m_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready, false);
+      fetch();
+      return m_data->second.is_signalled();
+    }
+
+    // Obtain the produced object; blocks the cpu until the job has run, and inserts a
+    // gpu-side wait on the job's fence, so the object can be used directly afterwards.
+    // Rethrows exceptions that occurred while running the job.
+    T get() {
+      gl_trace();
+      debug::check_expr(is_valid(), "AsyncResult::get() called on empty or consumed result");
+      fetch();
+      m_data->second.gpu_wait();
+      T t = std::move(m_data->first);
+      m_data.reset();
+      return t;
+    }
+  };
+
+  /**
+   * Async worker object; owns a hidden window whose context is shared with the main
+   * context, and a thread on which this context is current. Jobs such as buffer/texture
+   * uploads and program compilation are run in submission order on this thread, and
+   * return a gl::AsyncResult handle to the produced object.
+   *
+   * The worker must be constructed and destroyed on the main thread, as GLFW requires.
+   */
+  class AsyncWorker {
+    using JobType = std::move_only_function<void()>;
+
+    // Shared state between worker thread and submitting threads
+    struct StateData {
+      std::mutex              mutex;
+      std::condition_variable cv_jobs;
+      std::condition_variable cv_idle;
+      std::deque<JobType>     jobs;
+      uint                    n_running = 0;
+      bool                    is_stopped = false;
+    };
+
+    Window                     m_context;
+    std::unique_ptr<StateData> m_state;
+    std::thread                m_thread;
+
+    void push(JobType &&job);
+
+  public:
+    using InfoType = AsyncWorkerInfo;
+
+    /* constr/destr */
+
+    AsyncWorker() = default;
+    AsyncWorker(AsyncWorkerInfo info);
+    ~AsyncWorker();
+
+    /* job submission */
+
+    // Submit an arbitrary callable, which is invoked on the worker's context; a fence is
+    // inserted after the call, and commands are flushed before the fence is handed over, as
+    // a fence from another context is only guaranteed to signal once it is flushed
+    template <typename F, typename R = std::invoke_result_t<F>>
+    auto submit(F &&f) {
+      using T = std::conditional_t<std::is_void_v<R>, std::monostate, R>;
+      std::promise<std::pair<T, sync::Fence>> promise;
+      auto future = promise.get_future();
+      push([f = std::forward<F>(f), promise = std::move(promise)]() mutable {
+        try {
+          if constexpr (std::is_void_v<R>) {
+            f();
+            sync::Fence fence(sync::time_ns(0));
+            glFlush();
+            promise.set_value({ T { }, std::move(fence) });
+          } else {
+            T t = f();
+            sync::Fence fence(sync::time_ns(0));
+            glFlush();
+            promise.set_value({ std::move(t), std::move(fence) });
+          }
+        } catch (...) {
+          promise.set_exception(std::current_exception());
+        }
+      });
+      return AsyncResult<T>(std::move(future));
+    }
+
+    // Create and fill a buffer; provided data is copied before returning
+    AsyncResult<Buffer> upload_buffer(BufferInfo info);
+
+    // Create and fill a texture, and generate its mipmap chain if info.levels > 1;
+    // provided data is copied before returning
+    template <typename TextureTy>
+    AsyncResult<TextureTy> upload_texture(typename TextureTy::InfoType info) {
+      using T = typename decltype(info.data)::value_type;
+      std::vector<std::remove_cv_t<T>> data(range_iter(info.data));
+      return submit([info, data = std::move(data)]() mutable {
+        info.data = data;
+        TextureTy texture(info);
+        if (info.levels > 1)
+          texture.generate_mipmaps();
+        return texture;
+      });
+    }
+
+    // Compile and link a program; info objects are copied before returning
+    AsyncResult<Program> compile_program(std::vector<ShaderLoadFileInfo>   info);
+    AsyncResult<Program> compile_program(std::vector<ShaderLoadStringInfo> info);
+
+    /* state */
+
+    // Nr. of submitted jobs that have not yet completed
+    size_t n_pending() const;
+
+    // Block until all submitted jobs have run
+    void wait_idle() const;
+
+    inline bool is_init() const { return m_state != nullptr; }
+
+    /* miscellaneous */
+
+    inline void swap(AsyncWorker &o) {
+      gl_trace();
+      using std::swap;
+      m_context.swap(o.m_context);
+      swap(m_state, o.m_state);
+      swap(m_thread, o.m_thread);
+    }
+
+    inline bool operator==(const AsyncWorker &o) const {
+      return m_context == o.m_context && m_state == o.m_state;
+    }
+
+    gl_declare_noncopyable(AsyncWorker);
+  };
+} // namespace gl
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <small_gl/fwd.hpp>
+#include <small_gl/enum.hpp>
+#include <small_gl/utility.hpp>
+#include <small_gl/detail/eigen.hpp>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace gl {
+  /**
+   * Helper object to configure BCn encoding.
+   */
+  struct BCnEncodeInfo {
+    // Output format; BC1, BC4, BC5 and BC7 (and their sRGB variants) can be encoded
+    CompressedFormat format = CompressedFormat::eBC7;
+
+    // Nr. of interleaved components in input data; missing components read as 0, and alpha as 1
+    uint components = 4;
+
+    // Refine endpoints by a least-squares fit to each block's initial indices; roughly doubles
+    // encoding time for a modest gain in quality
+    bool is_refined = true;
+
+    // BC1 only; texels with alpha below this threshold are encoded as transparent
+    uint alpha_threshold = 128;
+  };
+
+  // Encode a 2d image of 8-bit unorm texels into 4x4 blocks of a compressed format; returns
+  // blocks in row-major order, ready for gl::CompressedTexture<...>::set(...). sRGB formats 
+  // are encoded as-is; their input is assumed sRGB-encoded already
+  std::vector<std::byte> encode_bcn(std::span<const std::byte> data, eig::Array2u size, BCnEncodeInfo info = { });
+} // namespace gl
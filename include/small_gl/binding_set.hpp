@@ -0,0 +1,121 @@
+#pragma once
+
+#include <small_gl/fwd.hpp>
+#include <small_gl/program.hpp>
+#include <small_gl/detail/handle.hpp>
+#include <small_gl/detail/trace.hpp>
+#include <string_view>
+#include <vector>
+
+namespace gl {
+  /**
+   * Binding set object; collects buffer, texture, sampler and image bindings for a single
+   * program, and commits them through ARB_multi_bind (glBindBuffersRange, glBindTextures,
+   * glBindSamplers, glBindImageTextures) in runs of contiguous binding points. Bindings that
+   * are unchanged since the last commit are skipped.
+   *
+   * Committed state is assumed to persist between commits; if bindings are changed outside
+   * of the set, e.g. by Program::bind(...) or another set, call invalidate() before commit().
+   * Batched image bindings use the texture's internal format and read-write access at level 0;
+   * images declared readonly/writeonly, layered textures, and textures of which the internal
+   * format is not a valid image format are bound individually, as by Program::bind(...).
+   */
+  class BindingSet {
+    using BindingType   = Program::BindingType;
+    using BindingAccess = Program::BindingAccess;
+    using BindingHandle = Program::BindingHandle;
+
+    // Internal struct used for buffer binding points
+    struct BufferData {
+      uint   object = 0;
+      size_t offset = 0;
+      size_t size   = 0;
+      bool   is_set = false;
+
+      auto operator<=>(const BufferData&) const = default;
+    };
+
+    // Internal struct used for texture, sampler and image binding points
+    struct ObjectData {
+      uint object = 0;
+      bool is_set = false;
+
+      auto operator<=>(const ObjectData&) const = default;
+    };
+
+    // Internal struct holding requested and last committed state for a binding namespace
+    template <typename T>
+    struct NamespaceData {
+      std::vector<T> pending;
+      std::vector<T> committed;
+
+      void set(uint binding, const T &t) {
+        if (pending.size() <= binding)
+          pending.resize(binding + 1);
+        pending[binding] = t;
+      }
+    };
+
+    Program                   *m_program = nullptr;
+    NamespaceData<BufferData>  m_uniform_buffers;
+    NamespaceData<BufferData>  m_storage_buffers;
+    NamespaceData<ObjectData>  m_textures;
+    NamespaceData<ObjectData>  m_samplers;
+    NamespaceData<ObjectData>  m_images;
+
+  public:
+    /* constr/destr */
+
+    BindingSet() = default;
+
+    // Construct a binding set for a program; the program must outlive the set
+    BindingSet(Program &program);
+
+    /* getters */
+
+    inline bool is_init() const { return m_program != nullptr; }
+    inline Program &program() const { return *m_program; }
+
+    /* state */
+
+    // Bind specific object to a name; the binding takes effect on commit()
+    void bind(std::string_view s, const gl::AbstractTexture &, const gl::Sampler &);
+    void bind(std::string_view s, const gl::AbstractTexture &);
+    void bind(std::string_view s, const gl::Sampler &);
+    void bind(std::string_view s, const gl::Buffer &, size_t size = 0, size_t offset = 0);
+
+    // Bind specific object to a pre-resolved binding handle; the binding takes effect on commit()
+    void bind(const BindingHandle &h, const gl::AbstractTexture &, const gl::Sampler &);
+    void bind(const BindingHandle &h, const gl::AbstractTexture &);
+    void bind(const BindingHandle &h, const gl::Sampler &);
+    void bind(const BindingHandle &h, const gl::Buffer &, size_t size = 0, size_t offset = 0);
+
+    // Issue all bindings that changed since the last commit
+    void commit();
+
+    // Forget committed state, so the next commit() issues all bindings
+    void invalidate();
+
+    // Forget all bindings, requested and committed
+    void clear();
+
+    /* miscellaneous */
+
+    inline void swap(BindingSet &o) {
+      gl_trace();
+      using std::swap;
+      swap(m_program, o.m_program);
+      swap(m_uniform_buffers, o.m_uniform_buffers);
+      swap(m_storage_buffers, o.m_storage_buffers);
+      swap(m_textures, o.m_textures);
+      swap(m_samplers, o.m_samplers);
+      swap(m_images, o.m_images);
+    }
+
+    inline bool operator==(const BindingSet &o) const {
+      return m_program == o.m_program;
+    }
+
+    gl_declare_noncopyable(BindingSet);
+  };
+} // namespace gl
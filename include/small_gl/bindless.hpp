@@ -0,0 +1,133 @@
+#pragma once
+
+#include <small_gl/fwd.hpp>
+#include <small_gl/buffer.hpp>
+#include <small_gl/detail/handle.hpp>
+#include <small_gl/detail/trace.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace gl {
+  // Test for ARB_bindless_texture support; if unavailable, ResidencyManager falls back on
+  // classic texture units, and draws that index many textures must be split
+  bool is_bindless_supported();
+
+  // Create bindless handles for a texture, or a texture/sampler pair; once a handle is created,
+  // the texture's (and sampler's) parameters become immutable. Handles are released only when
+  // the texture is deleted, and must be made non-resident beforehand
+  uint64_t texture_handle(const gl::AbstractTexture &texture);
+  uint64_t texture_handle(const gl::AbstractTexture &texture, const gl::Sampler &sampler);
+
+  /**
+   * Helper object to create residency manager object.
+   */
+  struct ResidencyManagerInfo {
+    // Nr. of slots in the handle table; slot indices are stable, and may serve as material IDs
+    uint max_textures = 1024;
+
+    // Budget for the summed size of resident textures, in bytes; 0 is unbounded. Textures used
+    // during the current frame are kept resident regardless
+    size_t max_resident_size = 0;
+
+    // Nr. of frames a texture may go unused before it is made non-resident
+    uint max_idle_frames = 8;
+  };
+
+  /**
+   * Residency manager object; assigns bindless texture handles to slots in a handle table
+   * buffer, which shaders index by slot (e.g. a material ID) as a std430 array of uvec2 or
+   * sampler2D under ARB_bindless_texture. Handles are made resident on first use in a frame,
+   * and non-resident after going unused for some frames, or when over budget, in
+   * least-recently-used order.
+   *
+   * Without bindless support, the table holds zeroes, and textures must be bound to classic
+   * units through bind_to(...) instead.
+   */
+  class ResidencyManager {
+    // Internal struct used for texture slots
+    struct SlotData {
+      uint64_t handle      = 0;
+      uint     texture     = 0;
+      uint     sampler     = 0;
+      size_t   size        = 0; // Estimated size of all levels, in bytes
+      uint64_t last_frame  = 0; // Last frame in which the slot was used
+      bool     is_used     = false;
+      bool     is_resident = false;
+    };
+
+    ResidencyManagerInfo               m_info;
+    bool                               m_is_bindless   = false;
+    std::vector<SlotData>              m_slots;
+    std::vector<uint>                  m_free_slots;
+    std::unordered_map<uint64_t, uint> m_handle_counts; // Nr. of resident slots per handle
+    gl::Buffer                         m_table;
+    size_t                             m_resident_size = 0;
+    uint64_t                           m_frame         = 0;
+
+    void make_resident(SlotData &slot);
+    void make_non_resident(SlotData &slot);
+
+  public:
+    using InfoType = ResidencyManagerInfo;
+
+    /* constr/destr */
+
+    ResidencyManager() = default;
+    ResidencyManager(ResidencyManagerInfo info);
+    ~ResidencyManager();
+
+    /* getters */
+
+    inline bool   is_init()       const { return m_table.is_init(); }
+    inline bool   is_bindless()   const { return m_is_bindless; }
+    inline size_t resident_size() const { return m_resident_size; }
+    inline uint64_t frame()       const { return m_frame; }
+    inline const ResidencyManagerInfo &info() const { return m_info; }
+
+    // Handle table; uint64_t per slot, bound as a storage or uniform buffer by the caller
+    inline const gl::Buffer &table() const { return m_table; }
+
+    /* slots */
+
+    // Register a texture, or texture/sampler pair, and return its table slot; the texture must
+    // stay alive until the slot is erased. Slots may share a texture, and thus a handle; it
+    // remains resident while any of its slots is resident
+    uint insert(const gl::AbstractTexture &texture);
+    uint insert(const gl::AbstractTexture &texture, const gl::Sampler &sampler);
+
+    // Release a slot, making its handle non-resident
+    void erase(uint slot);
+
+    // Mark a slot as used during the current frame, making its handle resident if necessary;
+    // call before the draws that index the slot are submitted
+    void use(uint slot);
+
+    // Fallback path; bind a slot's texture and sampler to a classic texture unit
+    void bind_to(uint slot, uint unit) const;
+
+    // End the current frame; make idle handles non-resident, and trim residency to budget
+    void end_frame();
+
+    /* miscellaneous */
+
+    inline void swap(ResidencyManager &o) {
+      gl_trace();
+      using std::swap;
+      swap(m_info, o.m_info);
+      swap(m_is_bindless, o.m_is_bindless);
+      swap(m_slots, o.m_slots);
+      swap(m_free_slots, o.m_free_slots);
+      swap(m_handle_counts, o.m_handle_counts);
+      m_table.swap(o.m_table);
+      swap(m_resident_size, o.m_resident_size);
+      swap(m_frame, o.m_frame);
+    }
+
+    inline bool operator==(const ResidencyManager &o) const {
+      return m_table == o.m_table;
+    }
+
+    gl_declare_noncopyable(ResidencyManager);
+  };
+} // namespace gl
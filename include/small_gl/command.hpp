@@ -0,0 +1,171 @@
+#pragma once
+
+#include <small_gl/fwd.hpp>
+#include <small_gl/enum.hpp>
+#include <small_gl/dispatch.hpp>
+#include <small_gl/utility.hpp>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <variant>
+#include <vector>
+
+namespace gl {
+  /**
+   * Helper object to create command buffer object.
+   */
+  struct CommandBufferInfo {
+    // Nr. of commands for which space is reserved up front
+    size_t reserve_commands = 256;
+
+    // Nr. of bytes of upload data for which space is reserved up front
+    size_t reserve_data     = 0;
+  };
+
+  namespace detail {
+    // Range into one of a command buffer's arenas
+    struct CommandRange {
+      uint offset = 0;
+      uint size   = 0;
+    };
+
+    // Shared record for state data of DrawInfo-like objects
+    struct StateRecord {
+      CommandRange                               capabilities;
+      std::optional<DrawOp>                      draw_op;
+      std::optional<LogicOp>                     logic_op;
+      std::optional<CullOp>                      cull_op;
+      std::optional<DepthOp>                     depth_op;
+      std::optional<std::pair<BlendOp, BlendOp>> blend_op;
+      const Array                               *bindable_array;
+      const Program                             *bindable_program;
+      const Framebuffer                         *bindable_framebuffer;
+    };
+
+    // Record equivalent of gl::DrawInfo
+    struct DrawRecord {
+      PrimitiveType type;
+      uint vertex_count, vertex_first, instance_count, vertex_base, instance_base;
+      StateRecord state;
+    };
+
+    // Record equivalent of gl::DrawIndirectInfo
+    struct DrawIndirectRecord {
+      PrimitiveType type;
+      const Buffer *buffer;
+      StateRecord state;
+    };
+
+    // Record equivalent of gl::MultiDrawInfo; draw commands are stored in an arena
+    struct MultiDrawRecord {
+      PrimitiveType type;
+      CommandRange commands;
+      StateRecord state;
+    };
+
+    // Record equivalent of gl::ComputeInfo
+    struct ComputeRecord {
+      uint groups_x, groups_y, groups_z;
+      const Program *bindable_program;
+    };
+
+    // Record equivalent of gl::ComputeIndirectInfo
+    struct ComputeIndirectRecord {
+      const Buffer  *buffer;
+      const Program *bindable_program;
+    };
+
+    // Record of a call to gl::sync::memory_barrier(...)
+    struct BarrierRecord {
+      BarrierFlags flags;
+    };
+
+    // Record of a call to gl::Buffer::set(...); data is stored in an arena
+    struct UploadRecord {
+      Buffer *buffer;
+      size_t  buffer_offset;
+      size_t  data_offset;
+      size_t  data_size;
+    };
+
+    using CommandRecord = std::variant<DrawRecord, DrawIndirectRecord, MultiDrawRecord,
+                                       ComputeRecord, ComputeIndirectRecord,
+                                       BarrierRecord, UploadRecord>;
+
+    // Reusable scratch state for replaying command records without allocating per command
+    struct CommandReplayState {
+      std::vector<state::ScopedSet> scoped_state;
+      MultiDrawInfo                 multidraw;
+    };
+  } // namespace detail
+
+  /**
+   * Command buffer object; records draw/compute dispatches, barriers and buffer
+   * uploads as compact, trivially copyable records without touching the OpenGL
+   * context, so recording can happen on any thread. Upload data is copied into
+   * a buffer-owned arena, so the source data need not outlive the call.
+   *
+   * A single command buffer must only be recorded into by one thread at a time;
+   * independent command buffers can be recorded in parallel. Recorded commands
+   * are replayed on the context thread by gl::dispatch_commands(...). Storage
+   * is retained by clear(), so reused buffers do not allocate once warmed up.
+   */
+  class CommandBuffer {
+    using CapabilityType = std::pair<DrawCapability, bool>;
+    using DrawCommand    = MultiDrawInfo::DrawCommand;
+
+    // Command record alongside its sort key
+    struct Command {
+      uint                  key;
+      detail::CommandRecord record;
+    };
+
+    std::vector<Command>        m_commands;
+    std::vector<CapabilityType> m_capabilities;
+    std::vector<DrawCommand>    m_draw_commands;
+    std::vector<std::byte>      m_data;
+
+    // Helper to copy state data from DrawInfo-like objects into a record
+    detail::StateRecord record_state(const auto &info);
+
+  public:
+    using InfoType = CommandBufferInfo;
+
+    /* constr/destr */
+
+    CommandBuffer() = default;
+    CommandBuffer(CommandBufferInfo info);
+
+    /* recording; key determines replay order in gl::dispatch_commands(...), ties preserve record order */
+
+    void record(const DrawInfo            &info, uint key = 0);
+    void record(const DrawIndirectInfo    &info, uint key = 0);
+    void record(const MultiDrawInfo       &info, uint key = 0);
+    void record(const ComputeInfo         &info, uint key = 0);
+    void record(const ComputeIndirectInfo &info, uint key = 0);
+    void record_barrier(BarrierFlags flags, uint key = 0);
+    void record_upload(Buffer &buffer, std::span<const std::byte> data, size_t offset = 0, uint key = 0);
+
+    template <typename Ty>
+    void record_upload_as(Buffer &buffer, std::span<const Ty> data, size_t offs = 0, uint key = 0) {
+      record_upload(buffer, std::as_bytes(data), offs * sizeof(Ty), key);
+    }
+
+    /* state */
+
+    // Remove recorded commands, but retain allocated storage
+    void clear();
+
+    inline size_t size() const { return m_commands.size(); }
+    inline bool empty() const { return m_commands.empty(); }
+
+  private:
+    friend void dispatch_commands(std::span<const CommandBuffer>);
+    void dispatch(const Command &command, detail::CommandReplayState &replay) const;
+  };
+
+  // Replay commands from one or more command buffers on the context thread; commands are
+  // merged in deterministic order of (key, buffer index in span, record order)
+  void dispatch_commands(std::span<const CommandBuffer> buffers);
+  void dispatch_commands(const CommandBuffer &buffer);
+} // namespace gl
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <small_gl/fwd.hpp>
+#include <small_gl/enum.hpp>
+#include <small_gl/utility.hpp>
+#include <small_gl/detail/eigen.hpp>
+#include <small_gl/detail/handle.hpp>
+#include <small_gl/detail/texture.hpp>
+#include <cstddef>
+#include <span>
+
+namespace gl {
+  namespace detail {
+    // Size in bytes of a single 4x4 block of a compressed format
+    constexpr uint compressed_block_size(CompressedFormat format) {
+      switch (format) {
+        case CompressedFormat::eBC1:
+        case CompressedFormat::eBC1Srgb:
+        case CompressedFormat::eBC4:
+        case CompressedFormat::eBC4Signed:
+          return 8;
+        default:
+          return 16;
+      }
+    }
+
+    // Size in bytes of a region of compressed blocks; partial blocks at edges count fully,
+    // and trailing array layers are not blocked
+    template <int N>
+    constexpr size_t compressed_size(CompressedFormat format, const eig::Array<uint, N, 1> &size) {
+      size_t n_blocks = static_cast<size_t>((size.x() + 3) / 4) * ((size.y() + 3) / 4);
+      if constexpr (N == 3)
+        n_blocks *= size.z();
+      return n_blocks * compressed_block_size(format);
+    }
+  } // namespace detail
+
+  /**
+   * Helper object to create compressed texture object.
+   */
+  template <TextureType Ty = TextureType::eImage>
+  class CompressedTextureInfo {
+    using vect = eig::Array<uint, detail::texture_dims<2, Ty>(), 1>;
+
+  public:
+    // Multi-dimensional size of the texture, in texels; array layers are trailing
+    vect size;
+
+    // Mipmap levels; 1 = no mipmap
+    uint levels = 1;
+
+    // Block-compressed format of texture storage
+    CompressedFormat format = CompressedFormat::eBC7;
+
+    // Non-owning span to compressed blocks of the base level, passed into texture
+    std::span<const std::byte> data = { };
+  };
+
+  /**
+   * Compressed texture object wrapping OpenGL texture object with block-compressed storage.
+   *
+   * Supports 2d textures and 2d texture arrays. Data is uploaded and read back as encoded
+   * blocks, e.g. produced by gl::encode_bcn(...) or loaded from a container file. Compressed
+   * textures can be sampled, but not bound as images or render targets, and mipmaps cannot
+   * be generated by OpenGL; upload each level instead.
+   */
+  template <TextureType Ty = TextureType::eImage>
+  class CompressedTexture : public AbstractTexture {
+    static_assert(Ty == TextureType::eImage || Ty == TextureType::eImageArray,
+      "CompressedTexture: only 2d textures and 2d texture arrays are supported");
+
+    using Base = detail::Handle<>;
+    using vect = eig::Array<uint, detail::texture_dims<2, Ty>(), 1>;
+
+    uint             m_levels;
+    vect             m_size;
+    CompressedFormat m_format;
+
+  public:
+    using InfoType = CompressedTextureInfo<Ty>;
+
+    /* constr/destr */
+
+    CompressedTexture() = default;
+    CompressedTexture(InfoType info);
+    ~CompressedTexture();
+
+    /* getters */
+
+    uint layers() const override {
+      if constexpr (Ty == TextureType::eImageArray)
+        return m_size.z();
+      else
+        return 0;
+    }
+
+    uint levels() const override {
+      return m_levels;
+    }
+
+    vect size() const {
+      return m_size;
+    }
+
+    CompressedFormat compressed_format() const {
+      return m_format;
+    }
+
+    // Size in bytes of a level's blocks, as reported by OpenGL
+    size_t compressed_size(uint level = 0) const;
+
+    /* state */
+
+    void bind_to(TextureTargetType target, uint index, uint level = 0) const override;
+
+    /* operands */
+
+    // Read back a level's blocks; data must hold at least compressed_size(level) bytes
+    void get(std::span<std::byte> data,
+             uint level = 0) const;
+
+    // Upload blocks to a region of a level; offset must be a multiple of 4, and size must be
+    // a multiple of 4 or extend to the level's edge
+    void set(std::span<const std::byte> data,
+             uint level                  = 0,
+             vect size                   = vect(0),
+             vect offset                 = vect(0));
+
+    /* miscellaneous */
+
+    // Not supported for compressed storage; fails if levels > 1
+    void generate_mipmaps() override;
+
+    // Format queries
+    uint internal_format() const override { return static_cast<uint>(m_format);                }
+    uint format()          const override { return GL_RGBA;                                    }
+    uint target()          const override { return detail::texture_target<2, Ty>();            }
+
+    inline void swap(CompressedTexture &o) {
+      gl_trace();
+      using std::swap;
+      Base::swap(o);
+      swap(m_levels, o.m_levels);
+      swap(m_size, o.m_size);
+      swap(m_format, o.m_format);
+    }
+
+    inline bool operator==(const CompressedTexture &o) const {
+      return Base::operator==(o)
+        && m_levels == o.m_levels
+        && m_format == o.m_format
+        && (m_size == o.m_size).all();
+    }
+
+    gl_declare_noncopyable(CompressedTexture);
+  };
+} // namespace gl
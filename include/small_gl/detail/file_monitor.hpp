@@ -0,0 +1,134 @@
+#pragma once
+
+#include <small_gl/utility.hpp>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace gl::detail {
+  // Lock-free single-producer, single-consumer ring queue; pushes to a full queue are
+  // dropped and set an overflow flag, which the consumer must handle conservatively
+  template <typename T, size_t N>
+  class RingQueue {
+    static_assert((N & (N - 1)) == 0, "RingQueue size must be a power of two");
+
+    std::array<T, N>    m_data;
+    std::atomic<size_t> m_head     = 0; // Written by consumer
+    std::atomic<size_t> m_tail     = 0; // Written by producer
+    std::atomic<bool>   m_overflow = false;
+
+  public:
+    // Producer; returns false, and flags overflow, if the queue is full
+    bool push(const T &t) {
+      size_t tail = m_tail.load(std::memory_order_relaxed);
+      if (tail - m_head.load(std::memory_order_acquire) == N) {
+        m_overflow.store(true, std::memory_order_release);
+        return false;
+      }
+      m_data[tail % N] = t;
+      m_tail.store(tail + 1, std::memory_order_release);
+      return true;
+    }
+
+    // Consumer; returns false if the queue is empty
+    bool pop(T &t) {
+      size_t head = m_head.load(std::memory_order_relaxed);
+      guard(head != m_tail.load(std::memory_order_acquire), false);
+      t = m_data[head % N];
+      m_head.store(head + 1, std::memory_order_release);
+      return true;
+    }
+
+    // Consumer; test and reset overflow flag; only written if set, so polling stays a single load
+    bool overflowed() {
+      guard(m_overflow.load(std::memory_order_acquire), false);
+      return m_overflow.exchange(false, std::memory_order_acq_rel);
+    }
+
+    bool empty() const {
+      return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+  };
+
+  // Background service that watches files for modification, and pushes the ids of changed
+  // files into a lock-free queue. On Linux, changes are reported by inotify on the files'
+  // parent directories, so editors that replace files by renaming are handled; elsewhere,
+  // or if inotify is unavailable, modification times are polled on the background thread.
+  // Reported changes may be spurious; consumers should confirm them, e.g. by FileWatcher.
+  class FileMonitor {
+    using QueueType = RingQueue<uint, 1024>;
+
+    // Internal state shared with the background thread
+    struct StateData {
+      std::mutex                                     mutex;
+      std::unordered_map<std::string, uint>          ids;     // Canonical path -> watch id
+      std::vector<fs::path>                          paths;   // Watch id -> canonical path
+      std::vector<fs::file_time_type>                times;   // Watch id -> last seen mtime; polling only
+      std::unordered_map<int, std::vector<uint>>     dirs;    // inotify watch descriptor -> watch ids
+      std::unordered_map<std::string, int>           dir_wds; // Directory path -> inotify watch descriptor
+      QueueType                                      queue;
+      std::atomic<bool>                              is_stopped = false;
+      int                                            inotify_fd = -1;
+    };
+
+    std::unique_ptr<StateData> m_state;
+    std::thread                m_thread;
+
+    // Background thread loops; these only access the shared state, as the monitor may be moved
+    static void run_inotify(StateData *state);
+    static void run_polling(StateData *state);
+
+  public:
+    /* constr/destr */
+
+    // Default constructor leaves the monitor uninitialized
+    FileMonitor() = default;
+
+    // Construct and start the background thread; force_polling skips inotify
+    explicit FileMonitor(bool force_polling);
+    ~FileMonitor();
+
+    /* getters */
+
+    inline bool is_init() const { return m_state != nullptr; }
+
+    // Test if inotify is used, instead of polling
+    bool is_event_driven() const;
+
+    /* watching */
+
+    // Start watching a file, and return its id; watching the same file twice returns the same id
+    uint watch(const fs::path &file_path);
+
+    // Pop the ids of changed files, and call f(id) for each; returns false if events were
+    // dropped on overflow, in which case every watched file should be treated as changed
+    template <typename F>
+    bool drain(F f) {
+      gl_trace();
+      guard(m_state, true);
+      uint id;
+      while (m_state->queue.pop(id))
+        f(id);
+      return !m_state->queue.overflowed();
+    }
+
+    /* miscellaneous */
+
+    inline void swap(FileMonitor &o) {
+      gl_trace();
+      using std::swap;
+      swap(m_state, o.m_state);
+      swap(m_thread, o.m_thread);
+    }
+
+    inline bool operator==(const FileMonitor &o) const {
+      return m_state == o.m_state;
+    }
+
+    gl_declare_noncopyable(FileMonitor);
+  };
+} // namespace gl::detail
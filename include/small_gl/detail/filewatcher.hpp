@@ -4,9 +4,12 @@
 #include <small_gl/detail/serialization.hpp>
 
 namespace gl::detail {
-  // Wrapper to encapsulate efsw file watcher library
+  // Wrapper to encapsulate efsw file watcher library; changes are detected by
+  // modification time first, and confirmed by content hash, so touched or copied
+  // files with unchanged contents do not register as changed
   class FileWatcher {
     fs::file_time_type mutable m_file_time;
+    uint64_t           mutable m_file_hash = 0;
     fs::path                   m_file_path;
 
   public:
@@ -17,27 +20,39 @@ namespace gl::detail {
       gl_trace();
       debug::check_expr(fs::exists(m_file_path));
       m_file_time = fs::last_write_time(m_file_path);
+      m_file_hash = io::hash_file(m_file_path);
     }
 
     bool update() const {
       gl_trace();
+      
+      // Modification time is cheap to test, and avoids rehashing unmodified files
       auto new_file_time = fs::last_write_time(m_file_path);
-      std::swap(m_file_time, new_file_time);
-      return new_file_time != m_file_time;
+      guard(new_file_time != m_file_time, false);
+      m_file_time = new_file_time;
+
+      auto new_file_hash = io::hash_file(m_file_path);
+      std::swap(m_file_hash, new_file_hash);
+      return new_file_hash != m_file_hash;
     }
 
+    inline uint64_t hash() const { return m_file_hash; }
+    inline const fs::path &path() const { return m_file_path; }
+
     operator bool() const { return update(); }
   
   public: // Binary data serialization
     void to_stream(std::ostream &str) const {
       gl_trace();
       io::to_stream(m_file_time, str);
+      io::to_stream(m_file_hash, str);
       io::to_stream(m_file_path, str);
     }
 
     void from_stream(std::istream &str) {
       gl_trace();
       io::from_stream(m_file_time, str);
+      io::from_stream(m_file_hash, str);
       io::from_stream(m_file_path, str);
     }
   };
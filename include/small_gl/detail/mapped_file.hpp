@@ -0,0 +1,38 @@
+#pragma once
+
+#include <small_gl/utility.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace gl::detail {
+  // Read-only memory mapping of a file's full contents
+  class MappedFile {
+    const std::byte *m_data = nullptr;
+    size_t           m_size = 0;
+    std::intptr_t    m_file_handle    = -1;      // POSIX descriptor or Win32 file handle
+    void            *m_mapping_handle = nullptr; // Win32 file mapping handle; unused on POSIX
+
+  public:
+    MappedFile() = default;
+    MappedFile(const fs::path &file_path);
+    ~MappedFile();
+
+    inline bool is_open() const { return m_data != nullptr || m_file_handle != -1; }
+    inline std::span<const std::byte> data() const { return { m_data, m_size }; }
+
+    inline void swap(MappedFile &o) {
+      using std::swap;
+      swap(m_data, o.m_data);
+      swap(m_size, o.m_size);
+      swap(m_file_handle, o.m_file_handle);
+      swap(m_mapping_handle, o.m_mapping_handle);
+    }
+
+    inline bool operator==(const MappedFile &o) const {
+      return m_data == o.m_data && m_size == o.m_size;
+    }
+
+    gl_declare_noncopyable(MappedFile);
+  };
+} // namespace gl::detail
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <small_gl/utility.hpp>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace gl::detail {
+  // Input to preprocess_glsl(...)
+  struct GLSLPreprocessInfo {
+    // GLSL source, and optional path of the source file, used to resolve relative includes
+    std::string_view source;
+    fs::path         source_path;
+
+    // Additional directories searched for #include "..." and #include <...>
+    std::span<const fs::path> include_dirs = { };
+
+    // Values of layout(constant_id = i) constants; unspecified constants keep their default value
+    std::span<const std::pair<uint, uint>> spec_const = { };
+
+    // Macro definitions, injected directly after the #version directive
+    std::span<const std::pair<std::string, std::string>> defines = { };
+  };
+
+  // Output of preprocess_glsl(...)
+  struct GLSLPreprocessData {
+    std::string           source;   // Preprocessed source, ready for glShaderSource
+    std::vector<fs::path> includes; // Canonical paths of all (transitively) included files
+  };
+
+  // Single-pass, tokenizer-based GLSL preprocessor for the non-SPIR-V path; strips
+  // layout(constant_id = i) qualifiers and substitutes specialization constant values,
+  // resolves #include directives recursively, and injects #define directives. Other
+  // directives are left to the driver. Output is cached, keyed on a hash of the source
+  // and inputs, and validated against the contents of included files.
+  GLSLPreprocessData preprocess_glsl(const GLSLPreprocessInfo &info);
+} // namespace gl::detail
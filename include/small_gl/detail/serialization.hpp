@@ -4,6 +4,9 @@
 #include <concepts>
 #include <istream>
 #include <ostream>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace gl::io {
   // Simple serializable contract to avoid use of interfaces on currently
@@ -14,6 +17,19 @@ namespace gl::io {
     { ty.from_stream(is) };
   };
 
+  // Opt-out trait for types that own heap data, and cannot be copied bytewise; these, and
+  // vectors or pairs containing them, are serialized element-wise. All other types, including
+  // those libstdc++ does not deem trivially copyable (e.g. std::pair<uint, uint>, Eigen
+  // types), are copied bytewise
+  template <typename Ty> struct is_elementwise                     : std::false_type { };
+  template <> struct is_elementwise<std::string>                   : std::true_type  { };
+  template <> struct is_elementwise<fs::path>                      : std::true_type  { };
+  template <typename Ty> struct is_elementwise<std::vector<Ty>>    : std::true_type  { };
+  template <typename A, typename B> struct is_elementwise<std::pair<A, B>> 
+  : std::bool_constant<is_elementwise<A>::value || is_elementwise<B>::value> { };
+  template <typename Ty> 
+  constexpr bool is_elementwise_v = is_elementwise<Ty>::value;
+
   // Serialization for most types
   template <typename Ty> requires (!is_serializable<Ty>)
   void to_stream(const Ty &ty, std::ostream &str) {
@@ -53,8 +69,22 @@ namespace gl::io {
     ty = s;
   }
 
+  // Serialization for std::pair of types that cannot be copied bytewise, e.g. strings
+  template <typename A, typename B> requires (is_elementwise_v<std::pair<A, B>>)
+  void to_stream(const std::pair<A, B> &ty, std::ostream &str) {
+    gl_trace();
+    to_stream(ty.first,  str);
+    to_stream(ty.second, str);
+  }
+  template <typename A, typename B> requires (is_elementwise_v<std::pair<A, B>>)
+  void from_stream(std::pair<A, B> &ty, std::istream &str) {
+    gl_trace();
+    from_stream(ty.first,  str);
+    from_stream(ty.second, str);
+  }
+
   // Serialization for std::vector of most types
-  template <typename Ty> requires (!is_serializable<Ty>)
+  template <typename Ty> requires (!is_serializable<Ty> && !is_elementwise_v<Ty>)
   void to_stream(const std::vector<Ty> &v, std::ostream &str) {
     gl_trace();
     size_t n = v.size();
@@ -62,7 +92,7 @@ namespace gl::io {
     using value_type = typename std::decay_t<decltype(v)>::value_type;
     str.write(reinterpret_cast<const char *>(v.data()), sizeof(value_type) * v.size());
   }
-  template <typename Ty> requires (!is_serializable<Ty>)
+  template <typename Ty> requires (!is_serializable<Ty> && !is_elementwise_v<Ty>)
   void from_stream(std::vector<Ty> &v, std::istream &str) {
     gl_trace();
     size_t n = 0;
@@ -82,8 +112,9 @@ namespace gl::io {
     ty.from_stream(str);
   }
 
-  // Serialization for vectors of objects fulfilling is_serializable contract
-  template <typename Ty> requires (is_serializable<Ty>)
+  // Serialization for vectors of objects fulfilling is_serializable contract, or
+  // which cannot be copied bytewise, e.g. strings or paths
+  template <typename Ty> requires (is_serializable<Ty> || is_elementwise_v<Ty>)
   void to_stream(const std::vector<Ty> &v, std::ostream &str) {
     gl_trace();
     size_t n = v.size();
@@ -91,7 +122,7 @@ namespace gl::io {
     for (const auto &ty : v)
       to_stream(ty, str);
   }
-  template <typename Ty> requires (is_serializable<Ty>)
+  template <typename Ty> requires (is_serializable<Ty> || is_elementwise_v<Ty>)
   void from_stream(std::vector<Ty> &v, std::istream &str) {
     gl_trace();
     size_t n = 0;
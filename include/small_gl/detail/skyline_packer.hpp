@@ -0,0 +1,51 @@
+#pragma once
+
+#include <small_gl/utility.hpp>
+#include <small_gl/detail/eigen.hpp>
+#include <optional>
+#include <vector>
+
+namespace gl::detail {
+  // Online skyline rectangle packer over a fixed-size area, using the bottom-left heuristic;
+  // rectangles are placed at the lowest position along the skyline where they fit, ties
+  // broken by the least wasted area below them. Individual rectangles cannot be freed, as
+  // the skyline does not track them; clear() the packer, or repack, to reclaim area.
+  class SkylinePacker {
+    // Internal struct used for skyline segments, ordered by x
+    struct NodeData {
+      uint x, y, width;
+    };
+
+    eig::Array2u          m_size = 0;
+    std::vector<NodeData> m_nodes;
+    size_t                m_used_area = 0;
+
+    // Find the height at which a rectangle of given width fits at node i, and the area wasted
+    // below it; returns false if it does not fit
+    bool fit(uint i, const eig::Array2u &size, uint &y, size_t &waste) const;
+
+  public:
+    /* constr/destr */
+
+    SkylinePacker() = default;
+    SkylinePacker(eig::Array2u size);
+
+    /* getters */
+
+    inline eig::Array2u size()      const { return m_size; }
+    inline size_t       used_area() const { return m_used_area; }
+
+    // Fraction of area covered by packed rectangles
+    inline float occupancy() const {
+      return m_size.prod() ? static_cast<float>(m_used_area) / static_cast<float>(m_size.prod()) : 0.f;
+    }
+
+    /* packing */
+
+    // Place a rectangle, returning its offset, or std::nullopt if it does not fit
+    std::optional<eig::Array2u> insert(eig::Array2u size);
+
+    // Reset to an empty area
+    void clear();
+  };
+} // namespace gl::detail
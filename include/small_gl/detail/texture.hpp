@@ -194,5 +194,16 @@ namespace gl {
     template <> consteval StorageType texture_storage_type<2, TextureType::eCubemapArray>()     { return StorageType::e3D; }
     template <> consteval StorageType texture_storage_type<2, TextureType::eMultisample>()      { return StorageType::e2DMSAA; }
     template <> consteval StorageType texture_storage_type<2, TextureType::eMultisampleArray>() { return StorageType::e3DMSAA; }
+
+    // Run GL pixel unpacks with tight row alignment, as rows of small levels, pages or regions 
+    // need not be 4-byte aligned; restores previous alignment after
+    template <typename F>
+    void with_unpack_alignment_1(F &&f) {
+      int alignment;
+      glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+      glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+      f();
+      glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+    }
   } // namespace detail
 } // namespace gl
\ No newline at end of file
@@ -6,9 +6,12 @@
 #include <fmt/ranges.h>
 #include <glad/glad.h>
 #include <exception>
+#include <functional>
 #include <iterator>
 #include <span>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 #include <utility>
 
@@ -22,6 +25,20 @@ namespace gl::detail {
     return { reinterpret_cast<T*>(data), s.size_bytes() / sizeof(T) };
   }
 
+  // Transparent string hash; enables heterogeneous lookup by std::string_view in
+  // unordered containers without constructing a temporary std::string
+  struct string_hash {
+    using is_transparent = void;
+
+    size_t operator()(std::string_view s) const noexcept {
+      return std::hash<std::string_view>{}(s);
+    }
+  };
+
+  // Shorthand for std::unordered_map over std::string keys with heterogeneous lookup
+  template <typename Ty>
+  using string_map = std::unordered_map<std::string, Ty, string_hash, std::equal_to<>>;
+
   // Provide a readable translation of error values returned by glGetError();
   inline
   std::string readable_gl_error(GLenum err) {
@@ -84,6 +84,7 @@ namespace gl {
     eMSAA               = GL_MULTISAMPLE,
     eCullOp             = GL_CULL_FACE,
     eDither             = GL_DITHER,
+    eRasterizerDiscard  = GL_RASTERIZER_DISCARD,
 
     // Blending capabilities
     eBlendOp            = GL_BLEND,
@@ -307,6 +308,20 @@ namespace gl {
     eImageReadWrite         = GL_READ_WRITE
   };
 
+  // Block-compressed formats for gl::CompressedTexture<...>; all use 4x4 texel blocks
+  enum class CompressedFormat : uint {
+    eBC1                    = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,       // RGB, 1-bit alpha; 8 bytes per block
+    eBC1Srgb                = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT,
+    eBC4                    = GL_COMPRESSED_RED_RGTC1,                // R; 8 bytes per block
+    eBC4Signed              = GL_COMPRESSED_SIGNED_RED_RGTC1,
+    eBC5                    = GL_COMPRESSED_RG_RGTC2,                 // RG; 16 bytes per block
+    eBC5Signed              = GL_COMPRESSED_SIGNED_RG_RGTC2,
+    eBC6H                   = GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT,  // RGB half float; 16 bytes per block
+    eBC6HSigned             = GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT,
+    eBC7                    = GL_COMPRESSED_RGBA_BPTC_UNORM,          // RGBA; 16 bytes per block
+    eBC7Srgb                = GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM
+  };
+
   /* Sampler enums */
   
   // Filter used for minimization in gl::Sampler
@@ -390,6 +405,33 @@ namespace gl {
   };
   gl_declare_bitflag(BarrierFlags);
 
+  /* Query enums */
+
+  // Query target for gl::Query(...) construction
+  enum class QueryType : uint {
+    // Timer queries
+    eTimeElapsed                      = GL_TIME_ELAPSED,
+    eTimestamp                        = GL_TIMESTAMP,
+
+    // Occlusion/primitive queries
+    eSamplesPassed                    = GL_SAMPLES_PASSED,
+    eAnySamplesPassed                 = GL_ANY_SAMPLES_PASSED,
+    ePrimitivesGenerated              = GL_PRIMITIVES_GENERATED,
+
+    // Pipeline statistics queries (GL_ARB_pipeline_statistics_query, core in 4.6)
+    eVerticesSubmitted                = GL_VERTICES_SUBMITTED,
+    ePrimitivesSubmitted              = GL_PRIMITIVES_SUBMITTED,
+    eVertexShaderInvocations          = GL_VERTEX_SHADER_INVOCATIONS,
+    eTessControlShaderPatches         = GL_TESS_CONTROL_SHADER_PATCHES,
+    eTessEvaluationShaderInvocations  = GL_TESS_EVALUATION_SHADER_INVOCATIONS,
+    eGeometryShaderInvocations        = GL_GEOMETRY_SHADER_INVOCATIONS,
+    eGeometryShaderPrimitivesEmitted  = GL_GEOMETRY_SHADER_PRIMITIVES_EMITTED,
+    eFragmentShaderInvocations        = GL_FRAGMENT_SHADER_INVOCATIONS,
+    eComputeShaderInvocations         = GL_COMPUTE_SHADER_INVOCATIONS,
+    eClippingInputPrimitives          = GL_CLIPPING_INPUT_PRIMITIVES,
+    eClippingOutputPrimitives         = GL_CLIPPING_OUTPUT_PRIMITIVES,
+  };
+
   /* Vertexarray enums */
 
   // Format used for gl::VertexArray(...) in gl::VertexAttribInfo(...) object
@@ -7,6 +7,7 @@ namespace gl {
   
   // OpenGL object wrappers
   struct Array;
+  struct BindingSet;
   struct Buffer;
   struct Fence;
   struct Framebuffer;
@@ -14,6 +15,7 @@ namespace gl {
   struct ProgramCache;
   struct Sampler;
   struct Shader;
+  struct TexturePool;
   struct Window;
   struct Query;
 
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <small_gl/fwd.hpp>
+#include <small_gl/program.hpp>
+#include <small_gl/texture.hpp>
+#include <small_gl/utility.hpp>
+#include <small_gl/detail/utility.hpp>
+#include <string>
+#include <type_traits>
+
+namespace gl {
+  /**
+   * Reduction operator applied by MipGenerator over each texel's footprint.
+   */
+  enum class MipReduction {
+    eAverage, // Mean of the footprint; regular mipmaps
+    eMin,     // Component-wise minimum
+    eMax,     // Component-wise maximum
+    eMinMax,  // Minimum of the x component and maximum of the y component; hierarchical-Z.
+              // The base level must hold both, e.g. equal depth values in x and y
+  };
+
+  /**
+   * Compute-based mip chain generator; fills the levels of a texture from its base level
+   * by a given reduction operator, through image load/store. Works for integer formats,
+   * arrays, cubemaps and 3d textures, which glGenerateTextureMipmap partially cannot handle.
+   * Dispatches reduce several levels at once through shared memory, for as long as
+   * intermediate levels have even sizes; remaining levels are reduced one per dispatch.
+   *
+   * Three-component formats have no image load/store equivalent, and depth, stencil and
+   * multisampled textures cannot be reduced this way; these are rejected at compile time.
+   */
+  class MipGenerator {
+  public:
+    // Type-erased texture description passed to dispatch(...)
+    struct DispatchInfo {
+      uint         object;          // Texture object
+      uint         levels;          // Nr. of levels in texture
+      uint         base_level;      // Level from which reduction starts
+      eig::Array3u size;            // Spatial size of level 0, padded with ones
+      uint         layers;          // Nr. of layers (or layer-faces), 1 if not layered
+      uint         dims;            // Nr. of spatial dimensions
+      bool         is_layered;
+      bool         is_integer;      // Integer values are averaged in double precision
+      std::string  image_type;      // GLSL image type, e.g. uimage2DArray
+      std::string  image_format;    // GLSL image format qualifier, e.g. rgba16ui
+      std::string  value_type;      // GLSL value type, e.g. uvec4
+      uint         internal_format; // Image internal format used for binding
+      MipReduction reduction;
+    };
+
+  private:
+    detail::string_map<Program> m_programs; // Compiled variants, keyed by generated source
+
+    void dispatch(const DispatchInfo &info);
+
+  public:
+    /* constr/destr */
+
+    MipGenerator() = default;
+
+    /* generation */
+
+    // Fill levels (base_level, levels) of a texture from base_level, using a reduction operator
+    template <typename T, uint D, uint C, TextureType Ty>
+    void generate(gl::Texture<T, D, C, Ty> &texture,
+                  MipReduction             reduction  = MipReduction::eAverage,
+                  uint                     base_level = 0) {
+      gl_trace_full();
+      static_assert(C != 3,
+        "MipGenerator: three-component formats have no image load/store format");
+      static_assert(!std::is_same_v<T, DepthComponent> && !std::is_same_v<T, StencilComponent>,
+        "MipGenerator: depth/stencil textures cannot be bound as images; reduce a color copy instead");
+      static_assert(Ty != TextureType::eMultisample && Ty != TextureType::eMultisampleArray,
+        "MipGenerator: multisampled textures have no mip levels");
+      debug::check_expr(reduction != MipReduction::eMinMax || C >= 2,
+        "MipGenerator: min-max reduction requires at least two components");
+      guard(base_level + 1 < texture.levels());
+
+      constexpr bool is_cubemap = detail::is_cubemap_type<Ty>;
+      constexpr bool is_layered = Ty != TextureType::eImage;
+      constexpr uint dims       = is_cubemap ? 2 : D;
+
+      // Split size into spatial extent and layers
+      auto size = texture.size();
+      DispatchInfo info = { .object          = texture.object(),
+                            .levels          = texture.levels(),
+                            .base_level      = base_level,
+                            .size            = eig::Array3u::Ones(),
+                            .layers          = 1,
+                            .dims            = dims,
+                            .is_layered      = is_layered,
+                            .is_integer      = !std::is_same_v<T, float>,
+                            .internal_format = detail::image_internal_format<C, T>(),
+                            .reduction       = reduction };
+      info.size.head<dims>() = size.template head<dims>();
+      if constexpr (Ty == TextureType::eImageArray)
+        info.layers = size[D];
+      else if constexpr (Ty == TextureType::eCubemap)
+        info.layers = 6;
+      else if constexpr (Ty == TextureType::eCubemapArray)
+        info.layers = size.z() * 6;
+
+      // GLSL type names
+      constexpr auto prefix = std::is_same_v<T, float> ? ""
+                            : (std::is_same_v<T, uint> || std::is_same_v<T, ushort>) ? "u" : "i";
+      if constexpr (Ty == TextureType::eImage)
+        info.image_type = fmt::format("{}image{}D", prefix, D);
+      else if constexpr (Ty == TextureType::eImageArray)
+        info.image_type = fmt::format("{}image{}DArray", prefix, D);
+      else if constexpr (Ty == TextureType::eCubemap)
+        info.image_type = fmt::format("{}imageCube", prefix);
+      else
+        info.image_type = fmt::format("{}imageCubeArray", prefix);
+      info.value_type = fmt::format("{}vec4", prefix);
+
+      constexpr auto channels = C == 1 ? "r" : C == 2 ? "rg" : "rgba";
+      constexpr auto bits     = sizeof(T) * 8;
+      constexpr auto suffix   = std::is_same_v<T, float> ? "f"
+                              : (std::is_same_v<T, uint> || std::is_same_v<T, ushort>) ? "ui" : "i";
+      info.image_format = fmt::format("{}{}{}", channels, bits, suffix);
+
+      dispatch(info);
+    }
+
+    // Release all compiled variants
+    inline void clear() { m_programs.clear(); }
+
+    /* miscellaneous */
+
+    inline void swap(MipGenerator &o) {
+      gl_trace();
+      using std::swap;
+      swap(m_programs, o.m_programs);
+    }
+
+    inline bool operator==(const MipGenerator &o) const {
+      return this == &o;
+    }
+
+    gl_declare_noncopyable(MipGenerator);
+  };
+} // namespace gl
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <small_gl/fwd.hpp>
+#include <small_gl/texture.hpp>
+#include <small_gl/utility.hpp>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace gl {
+  /**
+   * Downsampling filter used by generate_mip_chain(...).
+   */
+  enum class MipFilter {
+    eBox,    // 2x2(x2) average; fast, but prone to aliasing
+    eKaiser, // Kaiser-windowed sinc; sharper, with less aliasing
+  };
+
+  /**
+   * Helper object to configure CPU mip chain generation.
+   */
+  struct MipChainInfo {
+    // Downsampling filter
+    MipFilter filter = MipFilter::eBox;
+
+    // Nr. of levels to generate, including the base level; 0 generates the full chain
+    uint levels = 0;
+
+    // Treat the first three components as sRGB-encoded, and filter in linear space; integer
+    // values are normalized by their type's maximum, float values are assumed in [0, 1]
+    bool is_srgb = false;
+
+    // Weigh color components by alpha during filtering, so transparent texels do not bleed
+    // into their neighbours; four-component data only
+    bool is_alpha_weighted = false;
+
+    // Kaiser filter shape; half-width in destination texels, and window parameter
+    float kaiser_width = 3.f;
+    float kaiser_alpha = 4.f;
+  };
+
+  // Generate a mip chain on the CPU from base level data of a given size; returns all levels,
+  // including the base level, tightly packed in order. Levels are filtered from the previous
+  // level in floating point; unlike glGenerateTextureMipmap, integer formats are supported
+  template <typename T, uint D, uint C>
+  std::vector<T> generate_mip_chain(std::span<const T> data, eig::Array<uint, D, 1> size, MipChainInfo info = { });
+
+  // Upload a mip chain produced by generate_mip_chain(...) to all corresponding levels of a
+  // texture; for array textures, to a single layer, and for cubemaps, to a single face
+  template <typename T, uint D, uint C, TextureType Ty>
+  void set_mip_chain(gl::Texture<T, D, C, Ty>                 &texture,
+                     std::type_identity_t<std::span<const T>> chain,
+                     uint                                     layer = 0)
+                     requires(Ty == TextureType::eImage || Ty == TextureType::eImageArray || Ty == TextureType::eCubemap) {
+    gl_trace_full();
+    using vect = eig::Array<uint, detail::texture_dims<D, Ty>(), 1>;
+
+    eig::Array<uint, D, 1> size = texture.size().template head<D>();
+    size_t offset = 0;
+    detail::with_unpack_alignment_1([&] {
+      for (uint level = 0; level < texture.levels(); ++level) {
+        size_t level_size = static_cast<size_t>(size.prod()) * C;
+        guard_break(offset + level_size <= chain.size());
+        auto level_data = chain.subspan(offset, level_size);
+        if constexpr (Ty == TextureType::eCubemap) {
+          texture.set(level_data, layer, level, size);
+        } else if constexpr (Ty == TextureType::eImageArray) {
+          vect region_size = 1, region_offset = 0;
+          region_size.template head<D>() = size;
+          region_offset[D] = layer;
+          texture.set(level_data, level, region_size, region_offset);
+        } else {
+          texture.set(level_data, level, size);
+        }
+        offset += level_size;
+        size = (size / 2).max(1u);
+      }
+    });
+  }
+} // namespace gl
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <small_gl/fwd.hpp>
+#include <small_gl/program.hpp>
+#include <small_gl/utility.hpp>
+#include <small_gl/detail/utility.hpp>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gl {
+  /**
+   * Key identifying a single variant of a base shader; constants and definitions are
+   * applied on top of those already specified in the base shader's load info.
+   */
+  struct PermutationKey {
+    // Specialization constants; these override base constants of the same index
+    std::vector<std::pair<uint, uint>> spec_const = { };
+
+    // Macro definitions; these override base definitions of the same name. GLSL path only
+    std::vector<std::pair<std::string, std::string>> defines = { };
+
+  public:
+    // Order-independent hash and comparison of constants and definitions; neither allocates
+    uint64_t hash() const;
+    bool operator==(const PermutationKey &o) const;
+  };
+
+  /**
+   * Helper object to create permutation cache object.
+   */
+  struct PermutationCacheInfo {
+    // Base shader stages, from which all variants are derived
+    std::vector<ShaderLoadFileInfo> info;
+
+    // Budgets for resident variants; least-recently-used variants are evicted when either is
+    // exceeded. A budget of 0 is unbounded. The generic variant is never evicted, nor counted
+    size_t max_programs    = 64;
+    size_t max_binary_size = 0;  // Sum of program binary sizes, in bytes
+
+    // Compile variants asynchronously, falling back to the generic variant until ready
+    bool is_async = true;
+  };
+
+  /**
+   * Permutation cache object; lazily compiles variants of a single base shader on first
+   * use, and keeps resident variants under a program-count and binary-size budget. The
+   * generic variant, compiled from the base shader as-is, is resident at all times.
+   */
+  class PermutationCache {
+    // Internal functor used to hash keys by their contents
+    struct KeyHash {
+      size_t operator()(const PermutationKey &key) const { return key.hash(); }
+    };
+
+    // Internal struct used for resident variants
+    struct VariantData {
+      Program                                     program;
+      size_t                                      binary_size = 0;     // Known once the program is linked
+      bool                                        is_failed   = false; // Compile or link failed in async mode
+      std::list<const PermutationKey *>::iterator lru_it;              // Position in LRU list
+    };
+
+    using VariantMap = std::unordered_map<PermutationKey, VariantData, KeyHash>;
+
+    PermutationCacheInfo              m_info;
+    Program                           m_generic;
+    VariantMap                        m_variants;
+    std::list<const PermutationKey *> m_lru;         // Keys in order of last use, most recent first
+    size_t                            m_binary_size = 0;
+
+    // Record size of a linked variant, and evict other variants until within budget
+    void commit(VariantData &data);
+    void evict();
+
+  public:
+    using InfoType = PermutationCacheInfo;
+
+    /* constr/destr */
+
+    PermutationCache() = default;
+    PermutationCache(PermutationCacheInfo info);
+
+    /* getters */
+
+    inline bool   is_init()     const { return m_generic.is_init(); }
+    inline size_t size()        const { return m_variants.size(); }
+    inline size_t binary_size() const { return m_binary_size; }
+    inline const PermutationCacheInfo &info() const { return m_info; }
+
+    // Test if a variant is resident, not necessarily ready
+    bool contains(const PermutationKey &key) const;
+
+    /* variant access */
+
+    // Return the generic variant, compiled from the base shader as-is
+    inline Program &generic() { return m_generic; }
+
+    // Return the variant for a given key, compiling it on first use; in async mode, returns
+    // the generic variant while compilation of the requested variant is still in flight. In
+    // async mode, a failed variant throws once when resolved, and falls back to the generic 
+    // variant afterwards. Compiling a variant may evict others, which invalidates references
+    // returned by earlier calls; do not hold on to returned programs across calls
+    Program &at(const PermutationKey &key);
+
+    // Evict all variants, leaving only the generic variant
+    void clear();
+
+    /* miscellaneous */
+
+    inline void swap(PermutationCache &o) {
+      gl_trace();
+      using std::swap;
+      swap(m_info, o.m_info);
+      m_generic.swap(o.m_generic);
+      swap(m_variants, o.m_variants);
+      swap(m_lru, o.m_lru);
+      swap(m_binary_size, o.m_binary_size);
+    }
+
+    inline bool operator==(const PermutationCache &o) const {
+      return m_generic == o.m_generic;
+    }
+
+    gl_declare_noncopyable(PermutationCache);
+  };
+} // namespace gl
@@ -2,15 +2,22 @@
 
 #include <small_gl/fwd.hpp>
 #include <small_gl/detail/serialization.hpp>
+#include <small_gl/detail/file_monitor.hpp>
 #include <small_gl/detail/filewatcher.hpp>
+#include <small_gl/detail/mapped_file.hpp>
+#include <small_gl/detail/utility.hpp>
 #include <small_gl/utility.hpp>
+#include <chrono>
 #include <initializer_list>
 #include <filesystem>
+#include <functional>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <span>
 #include <variant>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace gl {  
   /**
@@ -36,6 +43,12 @@ namespace gl {
     // Pass in indexed SPIRV specialization constants
     std::vector<std::pair<uint, uint>> spec_const = { };
 
+    // Macro definitions injected after #version; GLSL path only
+    std::vector<std::pair<std::string, std::string>> defines = { };
+
+    // Directories searched for #include, after the GLSL file's own directory; GLSL path only
+    std::vector<fs::path> include_dirs = { };
+
   public: // Helpers for use in std::unordered_map in gl::ProgramCache
     std::string to_string() const;
     
@@ -64,6 +77,12 @@ namespace gl {
 
     // Pass in indexed SPIRV specialization constants
     std::vector<std::pair<uint, uint>> spec_const = { };
+
+    // Macro definitions injected after #version; GLSL path only
+    std::vector<std::pair<std::string, std::string>> defines = { };
+
+    // Directories searched for #include; GLSL path only
+    std::vector<fs::path> include_dirs = { };
   };
 
   /**
@@ -71,6 +90,7 @@ namespace gl {
    */
   class Program : public detail::Handle<> {
     using Base = detail::Handle<>;
+    friend class BindingSet;
 
     // Internal enum used for reflectance data
     enum class BindingType {
@@ -80,6 +100,7 @@ namespace gl {
       eStorageBuffer, // SSBOs
       eUniformBuffer, // UBOs, not uniforms
       eUniform,       // Classical uniforms; not supported in the SPIR-V pipeline
+      eMember,        // Members of uniform/storage blocks; carries layout data, but is not bindable
     };
 
     // Internal enum used for reflectance data
@@ -87,20 +108,30 @@ namespace gl {
 
     // Internal struct used for reflectance data
     struct BindingData {
-      BindingType   type    = BindingType::eAuto;
-      BindingAccess access  = BindingAccess::eReadWrite;
-      int           binding = -1;
+      BindingType   type         = BindingType::eAuto;
+      BindingAccess access       = BindingAccess::eReadWrite;
+      int           binding      = -1; // Binding point, or location for classic uniforms
+      int           offset       = -1; // Byte offset inside block; block members only
+      int           array_stride = 0;  // Byte stride between array elements; block members only
 
       auto operator<=>(const BindingData&) const = default;
     };
     
     // Map populated with object locations for reflectable string names, if available
-    std::unordered_map<std::string, BindingData> m_binding_data;
+    detail::string_map<BindingData> m_binding_data;
+
+    // Shader objects attached to a program whose compile/link status is not yet resolved
+    std::vector<uint> m_pending_shaders;
 
     // Populate some reflectance data
     void populate(fs::path refl_path); // Populate reflectance data from SPIRV-CROSS generated .json file
     void populate(io::json refl_json); // Populate reflectance data from SPIRV-CROSS generated .json data
+    void populate();                   // Populate reflectance data through program interface queries
     int  loc(std::string_view s);      // Look up classic uniform location for given string name
+    int  loc(const BindingData &h) const; // Test and return classic uniform location for given handle
+
+    // Look up reflected binding data for given string name; throws on missing name
+    const BindingData & lookup(std::string_view s) const;
 
   public: // Construction
     Program() = default;
@@ -118,9 +149,40 @@ namespace gl {
     Program(const ShaderLoadFileInfo   &info);
     Program(const ShaderLoadStringInfo &info);
 
+    // Asynchronous construction; compilation and linking are submitted without checking
+    // status, so the driver may compile in parallel (KHR_parallel_shader_compile). Test for
+    // completion using is_ready(), and use resolve() to check status before first use; 
+    // name-based binds and uniforms resolve automatically, but may then block
+    static Program make_async(std::span<const ShaderLoadFileInfo>   info);
+    static Program make_async(std::span<const ShaderLoadStringInfo> info);
+
+  private:
+    Program(std::span<const ShaderLoadFileInfo>   info, bool is_async);
+    Program(std::span<const ShaderLoadStringInfo> info, bool is_async);
+
+  public: // Compilation state
+    // Test if compilation and linking has completed without blocking
+    bool is_ready() const;
+
+    // Test if compilation and linking status still need to be checked
+    inline bool is_pending() const { return !m_pending_shaders.empty(); }
+
+    // Check compilation and linking status, blocking if necessary; throws on failure
+    void resolve();
+
+  public: // Binding handles
+    // Pre-resolved binding data for a reflected name or classic uniform; avoids per-call name 
+    // lookups in bind(...) and uniform(...). Handles are invalidated if the program is rebuilt
+    using BindingHandle = BindingData;
+
+    // Resolve a binding handle for a given name; throws on missing name
+    BindingHandle handle(std::string_view s);
+
   public: // Binding state  
     template <typename T>
     void uniform(std::string_view s, const T &t);
+    template <typename T>
+    void uniform(const BindingHandle &h, const T &t);
 
     // Bind specific object to a name; on BindingType::eAuto, populated object type is used
     void bind(std::string_view s, const gl::AbstractTexture &, const gl::Sampler &, BindingType binding = BindingType::eAuto);
@@ -128,6 +190,12 @@ namespace gl {
     void bind(std::string_view s, const gl::Sampler &, BindingType binding = BindingType::eAuto);
     void bind(std::string_view s, const gl::Buffer &,  size_t size = 0, size_t offset = 0, BindingType binding = BindingType::eAuto);
 
+    // Bind specific object to a pre-resolved binding handle
+    void bind(const BindingHandle &h, const gl::AbstractTexture &, const gl::Sampler &) const;
+    void bind(const BindingHandle &h, const gl::AbstractTexture &) const;
+    void bind(const BindingHandle &h, const gl::Sampler &) const;
+    void bind(const BindingHandle &h, const gl::Buffer &,  size_t size = 0, size_t offset = 0) const;
+
     void bind() const;
     void unbind() const;
     static void unbind_all();
@@ -142,6 +210,7 @@ namespace gl {
       using std::swap;
       Base::swap(o);
       swap(m_binding_data, o.m_binding_data);
+      swap(m_pending_shaders, o.m_pending_shaders);
     }
 
     inline bool operator==(const Program &o) const {
@@ -157,6 +226,14 @@ namespace gl {
    * based on their construction objects, to avoid unnecessary
    * recreation of some heavier program objects, and to help
    * serialize/deserialize program binaries to/from disk.
+   * 
+   * Cache files store independently compressed entries, followed
+   * by an uncompressed index; on load, the file is memory-mapped
+   * and only the index is read, and entries are decompressed and
+   * instantiated on first use. Entries are (de)compressed with zstd
+   * in parallel where batched; older zlib entries remain readable.
+   * Entries are indexed by the content hash of their shader data,
+   * so a copied cache remains valid under different file paths.
    */
   class ProgramCache {
     using InfoType = ShaderLoadFileInfo; 
@@ -164,14 +241,104 @@ namespace gl {
     // Data cache
     struct ProgramData {
       std::vector<InfoType>            info;     // Collective info used for construction
-      gl::Program                      program;  // Constructed program object
-      std::vector<detail::FileWatcher> watchers; // File watchers to help rebuild stale programs
+      uint64_t                         hash;     // Content hash over shader data, spec constants, and driver
+      gl::Program                      program;  // Constructed program object; uninitialized if stale on load
+      std::vector<detail::FileWatcher> watchers; // File watchers over all dependencies, including includes
+      bool                             is_dirty = true;  // Modified since last save/load; not serialized
+      bool                             is_stale = false; // Files changed according to file monitor; not serialized
+      std::string                      binary;           // Program binary read from a cache file, pending validation
     
     public: // Binary data serialization
       void to_stream(std::ostream &str) const;
       void from_stream(std::istream &str);
     };
-    std::unordered_map<std::string, ProgramData> m_data_cache;
+    detail::string_map<ProgramData> m_data_cache;
+
+    // Index data of a compressed entry in a cache file
+    struct IndexData {
+      std::string key;      // Key of the program that wrote the entry, for lookup without info
+      uint64_t offset;      // Offset of compressed entry from start of file
+      uint64_t size;        // Size of compressed entry
+      uint64_t size_raw;    // Size of entry after decompression
+      uint32_t codec;       // Compression codec used for entry
+      uint64_t driver_hash; // Hash of identity of the driver that produced the entry's program binary
+
+    public: // Binary data serialization
+      void to_stream(std::ostream &str) const;
+      void from_stream(std::istream &str);
+    };
+
+    // Memory-mapped cache file, index of entries not yet moved into the data cache by content
+    // hash, and map of program keys to their entries' content hashes
+    fs::path                        m_file_path;
+    detail::MappedFile              m_file;
+    detail::string_map<IndexData>   m_file_index;
+    detail::string_map<std::string> m_file_keys;
+
+    // Background file monitor, and map of its watch ids to the keys of dependent programs
+    detail::FileMonitor                                m_monitor;
+    std::unordered_map<uint, std::vector<std::string>> m_monitor_keys;
+
+    // Rebuild a program if its inputs changed, or if it was invalidated on load
+    void update(const std::string &key, ProgramData &data);
+
+    // Session usage recording; info of programs in order of first use, for warm-up manifests
+    bool                                  m_is_recording = false;
+    std::unordered_set<std::string>       m_manifest_keys;
+    std::vector<std::vector<InfoType>>    m_manifest;
+    std::chrono::steady_clock::time_point m_time_begin = std::chrono::steady_clock::now();
+
+    // Append a program to the manifest on first use, if recording
+    void record(const std::string &key, const ProgramData &data);
+
+    // Register a program's files with the file monitor
+    void monitor(const std::string &key, const ProgramData &data);
+
+    // Drain file monitor events, and flag dependent programs as stale
+    void poll_monitor();
+
+    // Find an entry in the mapped cache file by content hash of the given info, or by key if no info is given
+    detail::string_map<IndexData>::iterator find_file_entry(std::string_view key, std::span<const InfoType> info);
+
+    // Decompress and instantiate an entry from the mapped cache file, if it is indexed there
+    detail::string_map<ProgramData>::iterator fetch(std::string_view key, std::span<const InfoType> info = { });
+
+    // Decompress a batch of indexed entries in parallel, and instantiate them
+    void fetch(std::span<const std::string> keys, std::span<const std::vector<InfoType>> info = { });
+
+    // Deserialize a decompressed entry, and move it from the file index into the data cache under
+    // the given key; entries found by info take over its file paths, others are validated
+    detail::string_map<ProgramData>::iterator instantiate(detail::string_map<IndexData>::iterator f, std::string &&raw,
+                                                          std::string_view key, std::span<const InfoType> info);
+
+    // Map a cache file and read its index
+    void open(fs::path cache_file_path);
+
+    // Compressed entry data, ready to be written to a cache file
+    struct EntryData {
+      std::string            key;
+      IndexData              index;
+      std::vector<std::byte> data;
+    };
+
+    // Gather compressed entries for which pred(hash_key, is_dirty) holds; resident entries are
+    // serialized and compressed, entries not yet fetched from the mapped file are copied as-is
+    std::vector<EntryData> gather(std::function<bool(std::string_view, bool)> pred) const;
+
+    // Index of a cache file, alongside identity and binary formats of the driver that last wrote it
+    struct IndexFileData {
+      detail::string_map<IndexData> index;
+      uint64_t                      offset; // Offset of index block from start of file
+      std::string                   driver_id;
+      std::vector<uint>             binary_formats;
+    };
+
+    // Read the index of a cache file; returns nothing if the file is incompatible
+    static std::optional<IndexFileData> read_index(std::span<const std::byte> data);
+
+    // Write entries at the stream's current position, followed by the extended index and footer;
+    // entries supersede existing entries with the same content hash or program key
+    static void write(std::ostream &str, uint64_t offset, detail::string_map<IndexData> index, std::span<const EntryData> entries);
 
   public:
     // Default constructor
@@ -185,20 +352,60 @@ namespace gl {
     std::pair<std::string, gl::Program&> set(InfoType                        &&info); 
     std::pair<std::string, gl::Program&> set(std::initializer_list<InfoType> &&info); 
 
+    // Initialize-and-return references to a batch of program objects; all non-resident
+    // programs are submitted for compilation up front, so the driver may compile them in
+    // parallel. If resolve is false, status checks are deferred to first use through at()
+    std::vector<std::pair<std::string, gl::Program&>> set(std::span<const std::vector<InfoType>> info, 
+                                                           bool resolve = true);
+
     // Return an existing program for a given key
     gl::Program& at(const std::string &k);
 
+    // Rebuild only programs of which a file or (transitively) included file changed;
+    // all affected programs are submitted up front, so the driver may compile them in parallel
+    void refresh();
+
     // Reload programs from disk
     void reload();
 
     // Clear out program cache
     void clear();
 
-    // Save cache internals to file
-    void save(fs::path cache_file_path) const;
+    // Save cache internals to file; rewrites the full file
+    void save(fs::path cache_file_path);
+
+    // Append entries that were added or rebuilt since the last save/load to an existing
+    // cache file, rewriting only its index; falls back to save(...) if no cache file exists
+    void append(fs::path cache_file_path);
     
-    // Overwrite cache internals from file, if file exists
+    // Overwrite cache internals from file, if file exists; entries are instantiated on first use
     void load(fs::path cache_file_path);
+
+    // Decompress all entries in the loaded cache file in parallel, and instantiate them
+    void prefetch();
+
+  public: // Warm-up
+    // Output of warm_up(...)
+    struct WarmupData {
+      size_t                                   n_programs = 0; // Programs in manifest
+      size_t                                   n_compiled = 0; // Programs compiled by this call
+      std::chrono::duration<float, std::milli> duration   = { };
+    };
+
+    // Record the programs used by a session through at(...) and set(...), in order of first use
+    void start_recording();
+    void stop_recording();
+
+    // Save recorded programs to a manifest file
+    void save_manifest(fs::path manifest_path) const;
+
+    // Load and link all programs in a manifest file as a batch; optionally, issue a minimal
+    // draw per graphics program so the driver finalizes lazily compiled state up front
+    WarmupData warm_up(fs::path manifest_path, bool dummy_dispatch = false);
+
+    // Report the time since construction or load(...) of the cache; call once, after the
+    // first frame is presented
+    std::chrono::duration<float, std::milli> mark_first_frame();
   };
 
 } // namespace gl
\ No newline at end of file
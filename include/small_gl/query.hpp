@@ -0,0 +1,209 @@
+#pragma once
+
+#include <small_gl/fwd.hpp>
+#include <small_gl/enum.hpp>
+#include <small_gl/dispatch.hpp>
+#include <small_gl/detail/handle.hpp>
+#include <small_gl/detail/trace.hpp>
+#include <small_gl/detail/utility.hpp>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gl {
+  /**
+   * Helper object to create query object.
+   */
+  struct QueryInfo {
+    // Query target (timer, occlusion, pipeline statistics, ...)
+    QueryType type;
+  };
+
+  /**
+   * Query object wrapping OpenGL query object.
+   */
+  class Query : public detail::Handle<> {
+    using Base = detail::Handle<>;
+
+    QueryType m_type;
+    bool      m_is_active = false;
+
+  public:
+    using InfoType = QueryInfo;
+
+    /* constr/destr */
+
+    Query() = default;
+    Query(QueryInfo info);
+    ~Query();
+
+    /* getters */
+
+    inline QueryType type() const { return m_type; }
+    inline bool is_active() const { return m_is_active; }
+
+    /* query operands */
+
+    // Begin/end a query scope; not applicable to QueryType::eTimestamp
+    void begin();
+    void end();
+
+    // Record the GPU's timestamp; only applicable to QueryType::eTimestamp
+    void query_counter();
+
+    // Test if a result is available without stalling
+    bool is_available() const;
+
+    // Obtain the query result; stalls if the result is not yet available
+    uint64_t result() const;
+
+    /* miscellaneous */
+
+    inline void swap(Query &o) {
+      gl_trace();
+      using std::swap;
+      Base::swap(o);
+      swap(m_type, o.m_type);
+      swap(m_is_active, o.m_is_active);
+    }
+
+    inline bool operator==(const Query &o) const {
+      using std::tie;
+      return Base::operator==(o)
+        && tie(m_type, m_is_active) == tie(o.m_type, o.m_is_active);
+    }
+
+    gl_declare_noncopyable(Query);
+  };
+
+  /**
+   * Helper object storing (accumulated) pipeline statistics counters
+   * and elapsed gpu time, as returned by gl::PipelineQuery.
+   */
+  struct PipelineStatistics {
+    // Vertex assembly counters
+    uint64_t vertices_submitted                 = 0;
+    uint64_t primitives_submitted               = 0;
+
+    // Shader invocation counters
+    uint64_t vertex_shader_invocations          = 0;
+    uint64_t tess_control_shader_patches        = 0;
+    uint64_t tess_evaluation_shader_invocations = 0;
+    uint64_t geometry_shader_invocations        = 0;
+    uint64_t geometry_shader_primitives_emitted = 0;
+    uint64_t fragment_shader_invocations        = 0;
+    uint64_t compute_shader_invocations         = 0;
+
+    // Clipping counters
+    uint64_t clipping_input_primitives          = 0;
+    uint64_t clipping_output_primitives         = 0;
+
+    // Elapsed gpu time, in nanoseconds
+    uint64_t time_elapsed                       = 0;
+
+    // Nr. of resolved query scopes accumulated into this object
+    uint64_t n_samples                          = 0;
+
+  public:
+    PipelineStatistics & operator+=(const PipelineStatistics &o);
+
+    inline PipelineStatistics operator+(const PipelineStatistics &o) const {
+      PipelineStatistics s = *this;
+      return s += o;
+    }
+
+    auto operator<=>(const PipelineStatistics &) const = default;
+  };
+
+  /**
+   * Query set object wrapping all pipeline statistics queries and a
+   * timer query, which are begun/ended together around one or more
+   * draw/compute dispatches.
+   */
+  class PipelineQuery {
+    // Pipeline statistics counters, followed by timer query
+    constexpr static std::array<QueryType, 12> query_types = {
+      QueryType::eVerticesSubmitted,        QueryType::ePrimitivesSubmitted,
+      QueryType::eVertexShaderInvocations,  QueryType::eTessControlShaderPatches,
+      QueryType::eTessEvaluationShaderInvocations,
+      QueryType::eGeometryShaderInvocations,
+      QueryType::eGeometryShaderPrimitivesEmitted,
+      QueryType::eFragmentShaderInvocations,
+      QueryType::eComputeShaderInvocations,
+      QueryType::eClippingInputPrimitives,  QueryType::eClippingOutputPrimitives,
+      QueryType::eTimeElapsed
+    };
+
+    std::vector<Query> m_queries;
+
+  public:
+    /* constr/destr */
+
+    PipelineQuery() = default;
+    PipelineQuery(bool init);
+
+    /* query operands */
+
+    void begin();
+    void end();
+
+    // Test if all results are available without stalling
+    bool is_available() const;
+
+    // Obtain all query results; stalls if results are not yet available
+    PipelineStatistics result() const;
+
+    /* miscellaneous */
+
+    inline bool is_init() const { return !m_queries.empty(); }
+    inline bool is_active() const { return is_init() && m_queries.front().is_active(); }
+  };
+
+  /**
+   * Helper object to wrap draw/compute dispatches in pipeline queries under
+   * a string label, and to resolve and aggregate their results per label
+   * without stalling the pipeline; query sets are recycled after resolving.
+   */
+  class PipelineQueryCache {
+    // Data cache
+    struct QueryData {
+      std::deque<PipelineQuery>  pending; // In-flight query sets, oldest first
+      std::vector<PipelineQuery> free;    // Resolved query sets, available for reuse
+      PipelineStatistics         last;    // Most recently resolved statistics
+      PipelineStatistics         total;   // Accumulated statistics over all resolved scopes
+    };
+    detail::string_map<QueryData> m_data_cache;
+    QueryData *m_active = nullptr;
+
+  public:
+    // Begin/end a labelled query scope; scopes cannot be nested
+    void begin(std::string_view key);
+    void end();
+
+    // Wrap a single dispatch in a labelled query scope
+    void record(std::string_view key, const DrawInfo            &info);
+    void record(std::string_view key, const DrawIndirectInfo    &info);
+    void record(std::string_view key, const MultiDrawInfo       &info);
+    void record(std::string_view key, const ComputeInfo         &info);
+    void record(std::string_view key, const ComputeIndirectInfo &info);
+
+    // Gather results of available in-flight queries without stalling; call e.g. once per frame
+    void resolve();
+
+    // Return the accumulated/most recent statistics for a given key
+    const PipelineStatistics & at(std::string_view key) const;
+    const PipelineStatistics & last(std::string_view key) const;
+
+    // Return the set of keys with recorded scopes
+    std::vector<std::string> keys() const;
+
+    // Reset accumulated statistics, but keep query objects around
+    void reset();
+
+    // Clear out query cache
+    void clear();
+  };
+} // namespace gl
@@ -28,6 +28,10 @@ namespace gl {
 
     // Non-owning span to data passed into buffer
     std::span<const T> data = { };
+
+    // Allocate virtual storage only (ARB_sparse_texture); pages must be committed before use,
+    // and initial data cannot be provided
+    bool is_sparse = false;
   };
 
   /**
@@ -47,6 +51,7 @@ namespace gl {
 
     uint m_levels;
     vect m_size;
+    bool m_is_sparse = false;
 
   public:
     using InfoType = TextureInfo<T, D, Ty>;
@@ -74,10 +79,30 @@ namespace gl {
       return m_size; 
     }
 
+    bool is_sparse() const {
+      return m_is_sparse;
+    }
+
     /* state */
 
     void bind_to(TextureTargetType target, uint index, uint level = 0) const override;
 
+    /* sparse texture operands */
+
+    // Size of a single virtual page for this texture's format, in texels
+    vect page_size() const;
+
+    // Nr. of levels that can be committed per page; remaining levels form the mip tail,
+    // which is committed as a whole alongside any region of the last sparse level
+    uint sparse_levels() const;
+
+    // Commit or decommit physical memory for a page-aligned region of a level
+    void commit(bool commit                 = true,
+                uint level                  = 0,
+                vect size                   = vect(0),
+                vect offset                 = vect(0))
+                requires(!detail::is_cubemap_type<Ty>);
+
     /* operands for most texture types */
 
     void get(std::span<T> data,
@@ -86,10 +111,12 @@ namespace gl {
              vect offset                 = vect(0)) const
              requires(!detail::is_cubemap_type<Ty>);
 
+    // Unpack from a pixel buffer; data_offset is the byte offset of the region inside the buffer
     void set(const gl::Buffer &data,
              uint level                  = 0,
              vect size                   = vect(0),
-             vect offset                 = vect(0)) 
+             vect offset                 = vect(0),
+             size_t data_offset          = 0) 
              requires(!detail::is_cubemap_type<Ty>);
 
     void set(std::span<const T> data,
@@ -158,6 +185,7 @@ namespace gl {
       Base::swap(o);
       swap(m_levels, o.m_levels);
       swap(m_size, o.m_size);
+      swap(m_is_sparse, o.m_is_sparse);
     }
 
     inline bool operator==(const Texture &o) const {
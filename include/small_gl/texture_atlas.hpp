@@ -0,0 +1,130 @@
+#pragma once
+
+#include <small_gl/fwd.hpp>
+#include <small_gl/buffer.hpp>
+#include <small_gl/texture.hpp>
+#include <small_gl/detail/skyline_packer.hpp>
+#include <span>
+#include <vector>
+
+namespace gl {
+  /**
+   * Helper object to create texture atlas object.
+   */
+  struct TextureAtlasInfo {
+    // Size of each layer of the underlying texture array
+    eig::Array2u size = { 1024, 1024 };
+
+    // Initial nr. of layers; the array doubles in layers when an allocation does not fit
+    uint layers = 1;
+
+    // Texels left empty around each allocation, to avoid bleeding under filtering
+    uint padding = 1;
+  };
+
+  /**
+   * Texture atlas object; packs many small 2d images into the layers of a single 2d texture
+   * array, so they can be drawn without rebinding. Each layer is packed by a skyline packer.
+   * Allocations are identified by stable ids, which index a buffer of RectData records
+   * for shader lookup. Erased allocations leave holes until their layer is fully empty, or
+   * until defragment() repacks all live allocations.
+   */
+  template <typename T, uint C>
+  class TextureAtlas {
+  public:
+    using TextureArrayType = gl::Texture<T, 2, C, gl::TextureType::eImageArray>;
+
+    // Per-allocation record in the rect buffer; matches std430 struct { vec4 uv; uint layer; }
+    struct RectData {
+      eig::Array4f uv    = 0.f; // Normalized (u0, v0, u1, v1)
+      uint         layer = 0;
+      uint         _pad[3] = { };
+    };
+    static_assert(sizeof(RectData) == 32);
+
+  private:
+    // Internal struct used for live allocations
+    struct AllocData {
+      eig::Array2u offset = 0;
+      eig::Array2u size   = 0; // Excluding padding
+      uint         layer  = 0;
+      bool         is_used = false;
+    };
+
+    TextureAtlasInfo                   m_info;
+    TextureArrayType                   m_texture;
+    std::vector<detail::SkylinePacker> m_packers;     // Per layer
+    std::vector<uint>                  m_layer_count; // Per layer, nr. of live allocations
+    std::vector<AllocData>             m_allocs;      // Per id
+    std::vector<uint>                  m_free_ids;
+    std::vector<RectData>              m_rects;       // Per id
+    gl::Buffer                         m_buffer;
+    bool                               m_is_dirty = false;
+
+    // Find space for a padded allocation, growing the array if necessary; returns layer and offset
+    std::pair<uint, eig::Array2u> place(const eig::Array2u &padded_size);
+
+    // Reallocate texture array with a given nr. of layers, copying layers that fit
+    void resize(uint layers);
+
+    // Update the rect record for a given id
+    void update_rect(uint id);
+
+  public:
+    using InfoType = TextureAtlasInfo;
+
+    /* constr/destr */
+
+    TextureAtlas() = default;
+    TextureAtlas(TextureAtlasInfo info);
+
+    /* getters */
+
+    inline bool is_init() const { return m_texture.is_init(); }
+    inline uint layers()  const { return static_cast<uint>(m_packers.size()); }
+    inline const TextureArrayType &texture() const { return m_texture; }
+    inline const TextureAtlasInfo &info() const { return m_info; }
+
+    // Fraction of allocated layer area covered by live allocations, including padding
+    float occupancy() const;
+
+    // Rect record for a given id
+    inline const RectData &rect(uint id) const { return m_rects[id]; }
+
+    // Buffer of rect records indexed by id; uploads pending changes, and may be reallocated
+    const gl::Buffer &buffer();
+
+    /* allocation */
+
+    // Allocate a region for, and upload, a 2d image; returns the allocation's id
+    uint insert(eig::Array2u size, std::span<const T> data);
+
+    // Free an allocation; its area is reclaimed once its layer empties, or on defragment()
+    void erase(uint id);
+
+    // Repack all live allocations into as few layers as possible; ids remain valid
+    void defragment();
+
+    /* miscellaneous */
+
+    inline void swap(TextureAtlas &o) {
+      gl_trace();
+      using std::swap;
+      swap(m_info, o.m_info);
+      m_texture.swap(o.m_texture);
+      swap(m_packers, o.m_packers);
+      swap(m_layer_count, o.m_layer_count);
+      swap(m_allocs, o.m_allocs);
+      swap(m_free_ids, o.m_free_ids);
+      swap(m_rects, o.m_rects);
+      m_buffer.swap(o.m_buffer);
+      swap(m_is_dirty, o.m_is_dirty);
+    }
+
+    inline bool operator==(const TextureAtlas &o) const {
+      return m_texture == o.m_texture;
+    }
+
+    gl_declare_noncopyable(TextureAtlas);
+  };
+} // namespace gl
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <small_gl/fwd.hpp>
+#include <small_gl/framebuffer.hpp>
+#include <small_gl/renderbuffer.hpp>
+#include <small_gl/texture.hpp>
+#include <small_gl/utility.hpp>
+#include <initializer_list>
+#include <memory>
+#include <type_traits>
+#include <typeindex>
+#include <vector>
+
+namespace gl {
+  /**
+   * Helper object to create texture pool object.
+   */
+  struct TexturePoolInfo {
+    // During resizes, spatial sizes are rounded up to a multiple of this size
+    uint size_bucket = 128;
+
+    // Sizes are rounded up for this many frames after the last mark_resize()
+    uint resize_frames = 8;
+
+    // Objects unused for this many frames are released
+    uint max_idle_frames = 4;
+  };
+
+  /**
+   * Texture pool object; recycles transient textures, renderbuffers, and the framebuffers
+   * that reference them, across frames and passes. Objects are keyed by their type and size,
+   * and acquired objects remain in use until end_frame(), after which they may be handed out
+   * again; a pass acquiring the same objects every frame thus receives the same objects, and
+   * framebuffers over them are cached by their attachment set.
+   *
+   * When mark_resize() is called, e.g. on a window's did_framebuffer_resize(), sizes round up
+   * to size buckets for a few frames, so dragging a window border only reallocates once a
+   * bucket is crossed. Acquired objects may then be larger than requested; restrict viewports
+   * and texture coordinates to the requested size.
+   */
+  class TexturePool {
+    // Internal struct used for pooled textures and renderbuffers
+    struct ObjectData {
+      std::type_index                                type;
+      eig::Array4u                                   key;  // Size, padded with zeroes, and levels
+      std::unique_ptr<AbstractFramebufferAttachment> object;
+      uint64_t                                       last_used;
+      bool                                           is_used;
+    };
+
+    // Internal struct used for a single framebuffer attachment's identity
+    struct AttachmentData {
+      FramebufferType type;
+      uint            index, object, layer, level;
+
+      constexpr bool operator==(const AttachmentData &) const = default;
+    };
+
+    // Internal struct used for cached framebuffers; held by pointer, so returned references
+    // remain valid as other framebuffers are added or erased
+    struct FramebufferData {
+      std::vector<AttachmentData>      attachments;
+      std::unique_ptr<gl::Framebuffer> framebuffer;
+      uint64_t                         last_used;
+    };
+
+    TexturePoolInfo              m_info;
+    std::vector<ObjectData>      m_objects;
+    std::vector<FramebufferData> m_framebuffers;
+    uint64_t                     m_frame        = 0;
+    uint64_t                     m_resize_frame = 0;
+    bool                         m_is_resizing  = false;
+
+    // Round spatial size components up to size buckets, if resizing
+    eig::Array3u bucket(const eig::Array3u &size, uint dims) const;
+
+    // Find an unused object with matching key, or return nullptr
+    AbstractFramebufferAttachment *find(std::type_index type, const eig::Array4u &key);
+
+    // Take ownership over a newly created object under a key
+    void insert(std::type_index type, const eig::Array4u &key, std::unique_ptr<AbstractFramebufferAttachment> object);
+
+  public:
+    using InfoType = TexturePoolInfo;
+
+    /* constr/destr */
+
+    TexturePool() = default;
+    TexturePool(TexturePoolInfo info);
+
+    /* getters */
+
+    inline bool   is_resizing()       const { return m_is_resizing; }
+    inline size_t n_objects()         const { return m_objects.size(); }
+    inline size_t n_framebuffers()    const { return m_framebuffers.size(); }
+
+    /* acquisition */
+
+    // Acquire a texture of at least a given size and given levels; array layers and levels
+    // are matched exactly. Contents are undefined
+    template <typename T, uint D, uint C, TextureType Ty = TextureType::eImage,
+              typename vect = eig::Array<uint, detail::texture_dims<D, Ty>(), 1>>
+    gl::Texture<T, D, C, Ty> &texture(std::type_identity_t<vect> size, uint levels = 1) {
+      gl_trace();
+      using PooledTexture = gl::Texture<T, D, C, Ty>;
+      constexpr uint dims = detail::is_cubemap_type<Ty> ? 2 : D;
+
+      eig::Array4u key = 0;
+      eig::Array3u padded = 0;
+      padded.head<vect::RowsAtCompileTime>() = size;
+      key.head<3>() = bucket(padded, dims);
+      key.w()       = levels;
+
+      if (auto object = find(typeid(PooledTexture), key))
+        return dynamic_cast<PooledTexture &>(*object);
+
+      auto object = std::make_unique<PooledTexture>(typename PooledTexture::InfoType {
+        .size = key.head<vect::RowsAtCompileTime>(), .levels = levels });
+      auto &texture = *object;
+      insert(typeid(PooledTexture), key, std::move(object));
+      return texture;
+    }
+
+    // Acquire a renderbuffer of at least a given size. Contents are undefined
+    template <typename T, uint C, RenderbufferType Ty = RenderbufferType::eImage>
+    gl::Renderbuffer<T, C, Ty> &renderbuffer(eig::Array2u size) {
+      gl_trace();
+      using PooledRenderbuffer = gl::Renderbuffer<T, C, Ty>;
+
+      eig::Array4u key = 0;
+      key.head<3>() = bucket({ size.x(), size.y(), 0 }, 2);
+
+      if (auto object = find(typeid(PooledRenderbuffer), key))
+        return dynamic_cast<PooledRenderbuffer &>(*object);
+
+      auto object = std::make_unique<PooledRenderbuffer>(RenderBufferInfo { .size = key.head<2>() });
+      auto &renderbuffer = *object;
+      insert(typeid(PooledRenderbuffer), key, std::move(object));
+      return renderbuffer;
+    }
+
+    // Acquire a framebuffer over a set of attachments; framebuffers are cached by their
+    // attachments' object handles, so attachments not owned by the pool must outlive the
+    // pool's idle period, as deleted handles may be reused by OpenGL
+    gl::Framebuffer &framebuffer(std::initializer_list<FramebufferAttachmentInfo> info);
+
+    /* frame management */
+
+    // Mark the target size as changed in this frame, starting or extending size bucketing
+    void mark_resize();
+
+    // Release all acquired objects for reuse, and destroy objects and framebuffers left idle
+    void end_frame();
+
+    // Destroy all pooled objects and framebuffers
+    void clear();
+
+    /* miscellaneous */
+
+    inline void swap(TexturePool &o) {
+      gl_trace();
+      using std::swap;
+      swap(m_info, o.m_info);
+      swap(m_objects, o.m_objects);
+      swap(m_framebuffers, o.m_framebuffers);
+      swap(m_frame, o.m_frame);
+      swap(m_resize_frame, o.m_resize_frame);
+      swap(m_is_resizing, o.m_is_resizing);
+    }
+
+    inline bool operator==(const TexturePool &o) const {
+      return this == &o;
+    }
+
+    gl_declare_noncopyable(TexturePool);
+  };
+} // namespace gl
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <small_gl/fwd.hpp>
+#include <small_gl/buffer.hpp>
+#include <small_gl/texture.hpp>
+#include <small_gl/utility.hpp>
+#include <deque>
+#include <optional>
+#include <span>
+#include <type_traits>
+
+namespace gl {
+  /**
+   * Helper object to create texture streamer object.
+   */
+  struct TextureStreamerInfo {
+    // Size of the pixel buffer ring, in bytes; a single upload cannot exceed this size
+    size_t size = 64 * 1024 * 1024;
+
+    // Copy client data into the ring on multiple threads, for uploads above this size in
+    // bytes; 0 disables parallel copies
+    size_t parallel_copy_size = 4 * 1024 * 1024;
+  };
+
+  /**
+   * Texture streamer object; owns a persistently mapped pixel buffer ring, into which
+   * client data is copied and from which texture regions are unpacked. Each upload's
+   * region of the ring is fenced, and only reused once the fence is signalled, so uploads
+   * never wait on the GPU; if the ring has no free region, set(...) returns false instead,
+   * and the caller should retry the upload later, e.g. next frame.
+   */
+  class TextureStreamer {
+    // Internal struct used for in-flight ring regions
+    struct RegionData {
+      size_t      offset;
+      size_t      size;
+      sync::Fence fence;
+    };
+
+    TextureStreamerInfo    m_info;
+    gl::Buffer             m_buffer;
+    std::span<std::byte>   m_mapping;
+    std::deque<RegionData> m_regions; // In-flight regions, in order of submission
+    size_t                 m_head = 0; // Next write offset in the ring
+
+    // Find an offset for a region of the ring that is not in flight
+    std::optional<size_t> place(size_t size) const;
+
+    // Reserve a region of the ring that is not in flight, and copy data into it
+    std::optional<size_t> stage(std::span<const std::byte> data);
+
+    // Fence the most recently staged region, after its unpack is issued
+    void submit(size_t offset, size_t size);
+
+  public:
+    using InfoType = TextureStreamerInfo;
+
+    /* constr/destr */
+
+    TextureStreamer() = default;
+    TextureStreamer(TextureStreamerInfo info);
+    ~TextureStreamer();
+
+    /* getters */
+
+    inline bool   is_init()      const { return m_buffer.is_init(); }
+    inline size_t size()         const { return m_info.size; }
+    inline size_t n_in_flight()  const { return m_regions.size(); }
+
+    /* uploads */
+
+    // Stage data and unpack it into a texture region; returns false without side effects if
+    // the ring has no free region large enough to hold the data
+    template <typename T, uint D, uint C, TextureType Ty,
+              typename vect = eig::Array<uint, detail::texture_dims<D, Ty>(), 1>>
+    bool set(gl::Texture<T, D, C, Ty>                    &texture,
+             std::type_identity_t<std::span<const T>>    data,
+             uint                                        level  = 0,
+             std::type_identity_t<vect>                  size   = vect(0),
+             std::type_identity_t<vect>                  offset = vect(0))
+             requires(!detail::is_cubemap_type<Ty>) {
+      gl_trace_full();
+
+      if (size.isZero())
+        size = texture.size();
+      debug::check_expr(data.size() >= static_cast<size_t>(size.prod()) * C,
+        "provided data span is too small for requested texture region to be written");
+
+      auto data_bytes = std::as_bytes(data);
+      auto staged     = stage(data_bytes);
+      guard(staged, false);
+
+      detail::with_unpack_alignment_1([&] { texture.set(m_buffer, level, size, offset, *staged); });
+      submit(*staged, data_bytes.size());
+      return true;
+    }
+
+    // Test if an upload of a given size in bytes currently fits in the ring, so callers may
+    // skip producing data that set(...) would reject; releases signalled regions first
+    bool can_stage(size_t size);
+
+    // Release regions of which the fence has been signalled; this happens implicitly on set(...)
+    void poll();
+
+    /* miscellaneous */
+
+    inline void swap(TextureStreamer &o) {
+      gl_trace();
+      using std::swap;
+      swap(m_info, o.m_info);
+      m_buffer.swap(o.m_buffer);
+      swap(m_mapping, o.m_mapping);
+      swap(m_regions, o.m_regions);
+      swap(m_head, o.m_head);
+    }
+
+    inline bool operator==(const TextureStreamer &o) const {
+      return m_buffer == o.m_buffer;
+    }
+
+    gl_declare_noncopyable(TextureStreamer);
+  };
+} // namespace gl
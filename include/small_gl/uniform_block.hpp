@@ -0,0 +1,165 @@
+#pragma once
+
+#include <small_gl/fwd.hpp>
+#include <small_gl/buffer.hpp>
+#include <small_gl/utility.hpp>
+#include <small_gl/detail/eigen.hpp>
+#include <small_gl/detail/utility.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace gl {
+  namespace detail {
+    template <typename T>
+    struct is_span : std::false_type { };
+    template <typename T, size_t E>
+    struct is_span<std::span<T, E>> : std::true_type { };
+  } // namespace detail
+
+  /**
+   * Helper object to create uniform block object.
+   */
+  struct UniformBlockInfo {
+    // Linked program object from which the block layout is reflected
+    const Program *program = nullptr;
+
+    // Name of the uniform block, as declared in GLSL (not the instance name)
+    std::string name;
+  };
+
+  /**
+   * Uniform block object; reflects the layout of a named uniform block in a
+   * program, and stages member writes in a CPU-side shadow copy with the
+   * block's offsets and strides. Writes are uploaded as a single buffer
+   * update of the modified range on commit(), which also binds the backing
+   * buffer to the block's binding point.
+   *
+   * Note: only named blocks are supported; the default uniform block cannot
+   * be backed by a buffer object, and remains accessible through Program::uniform.
+   */
+  class UniformBlock {
+    // Internal struct used for reflectance data of block members
+    struct MemberData {
+      size_t offset        = 0;
+      size_t array_stride  = 0;
+      size_t matrix_stride = 0;
+      uint   array_size    = 1;
+    };
+
+    detail::string_map<MemberData> m_members;
+    std::vector<std::byte>         m_data;
+    Buffer                         m_buffer;
+    uint                           m_binding = 0;
+
+    // Modified byte range of the shadow copy, which is uploaded on commit()
+    size_t m_dirty_begin = std::numeric_limits<size_t>::max();
+    size_t m_dirty_end   = 0;
+
+    // Look up reflected member data for a given name; throws on missing name
+    const MemberData & lookup(std::string_view s) const;
+
+    // Copy bytes into the shadow copy, and expand the modified range
+    void write_bytes(size_t offset, const void *data, size_t size) {
+      std::memcpy(m_data.data() + offset, data, size);
+      m_dirty_begin = std::min(m_dirty_begin, offset);
+      m_dirty_end   = std::max(m_dirty_end,   offset + size);
+    }
+
+    // Write a single value; bools are widened and matrix columns are placed at matrix stride
+    template <typename T>
+    void write(const MemberData &member, size_t offset, const T &t) {
+      if constexpr (std::is_same_v<T, bool>) {
+        uint v = t ? 1u : 0u;
+        write_bytes(offset, &v, sizeof(uint));
+      } else if constexpr (requires { T::ColsAtCompileTime; }) {
+        using Scalar = typename T::Scalar;
+        if constexpr (T::ColsAtCompileTime > 1) {
+          static_assert(!T::IsRowMajor, "UniformBlock expects column-major matrices");
+          for (uint c = 0; c < T::ColsAtCompileTime; ++c)
+            write_bytes(offset + c * member.matrix_stride,
+                        t.data() + c * T::RowsAtCompileTime,
+                        T::RowsAtCompileTime * sizeof(Scalar));
+        } else {
+          write_bytes(offset, t.data(), T::RowsAtCompileTime * sizeof(Scalar));
+        }
+      } else {
+        static_assert(std::is_trivially_copyable_v<T>);
+        write_bytes(offset, &t, sizeof(T));
+      }
+    }
+
+  public:
+    using InfoType = UniformBlockInfo;
+
+    /* constr/destr */
+
+    UniformBlock() = default;
+    UniformBlock(UniformBlockInfo info);
+
+    /* getters */
+
+    inline uint binding() const { return m_binding; }
+    inline const Buffer &buffer() const { return m_buffer; }
+    inline bool is_init() const { return m_buffer.is_init(); }
+    inline bool is_dirty() const { return m_dirty_begin < m_dirty_end; }
+
+    // Test if the block contains a member of the given name
+    bool contains(std::string_view s) const;
+
+    /* staging */
+
+    // Stage a value for a block member
+    template <typename T> requires (!detail::is_span<T>::value)
+    void set(std::string_view s, const T &t) {
+      gl_trace();
+      const auto &member = lookup(s);
+      write(member, member.offset, t);
+    }
+
+    // Stage a range of values for an array member in one call, starting at a given element
+    template <typename T, size_t E>
+    void set(std::string_view s, std::span<T, E> t, uint first = 0) {
+      gl_trace();
+      const auto &member = lookup(s);
+      if (first + t.size() > member.array_size)
+        debug::check_expr(false,
+          fmt::format("UniformBlock::set(...) exceeds array size for member name: \"{}\"", s));
+      for (uint i = 0; i < t.size(); ++i)
+        write(member, member.offset + (first + i) * member.array_stride, t[i]);
+    }
+
+    /* state */
+
+    // Upload the modified range of staged values, if any, and bind the buffer to the block's binding
+    void commit();
+
+    // Bind the buffer to the block's binding without uploading staged values
+    void bind() const;
+
+    /* miscellaneous */
+
+    inline void swap(UniformBlock &o) {
+      gl_trace();
+      using std::swap;
+      swap(m_members, o.m_members);
+      swap(m_data, o.m_data);
+      m_buffer.swap(o.m_buffer);
+      swap(m_binding, o.m_binding);
+      swap(m_dirty_begin, o.m_dirty_begin);
+      swap(m_dirty_end, o.m_dirty_end);
+    }
+
+    inline bool operator==(const UniformBlock &o) const {
+      return m_buffer == o.m_buffer && m_binding == o.m_binding;
+    }
+
+    gl_declare_noncopyable(UniformBlock);
+  };
+} // namespace gl
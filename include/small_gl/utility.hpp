@@ -26,6 +26,9 @@ namespace gl {
 
   VendorType get_vendor();
 
+  // Driver identity string, formatted as "vendor;renderer;version"
+  std::string get_driver_id();
+
   namespace fs = std::filesystem; // STL namespace shorthand
 
   namespace io {
@@ -39,6 +42,10 @@ namespace gl {
 
     // Load json file to parseable structure
     json load_json(const fs::path &path);
+
+    // Fast non-cryptographic 64-bit content hash (xxHash3); chain hashes by passing a seed
+    uint64_t hash_bytes(std::span<const std::byte> data, uint64_t seed = 0);
+    uint64_t hash_file(const fs::path &path, uint64_t seed = 0);
   } // namespace io
 
   namespace sync {
@@ -72,6 +79,9 @@ namespace gl {
       void cpu_wait(); // blocking time
       void gpu_wait();
 
+      // Test if the fence has been signalled without blocking
+      bool is_signalled() const;
+
       inline void swap(Fence &o) {
         gl_trace();
         using std::swap;
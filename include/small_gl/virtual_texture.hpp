@@ -0,0 +1,160 @@
+#pragma once
+
+#include <small_gl/fwd.hpp>
+#include <small_gl/buffer.hpp>
+#include <small_gl/texture.hpp>
+#include <small_gl/texture_streamer.hpp>
+#include <small_gl/utility.hpp>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace gl {
+  // Test for ARB_sparse_texture support; required by VirtualTexture
+  bool is_sparse_supported();
+
+  /**
+   * Helper object to create virtual texture object.
+   */
+  template <typename T, uint C>
+  struct VirtualTextureInfo {
+    // Size and nr. of levels of the full, virtual texture
+    eig::Array2u size;
+    uint         levels = 1;
+
+    // Page loader; fills data with C-component texels for a region of a level. Called on the
+    // thread calling update(), for requested pages and once for each level of the mip tail
+    std::function<void(uint level, eig::Array2u offset, eig::Array2u size, std::span<T> data)> loader;
+
+    // Budget for committed pages, in bytes; the mip tail is not counted
+    size_t max_resident_size = 256 * 1024 * 1024;
+
+    // Max. nr. of pages committed and streamed per update(...)
+    uint max_pages_per_update = 32;
+
+    // Settings for the staging ring through which pages are uploaded
+    TextureStreamerInfo staging = { };
+  };
+
+  /**
+   * Virtual texture object; backs a large 2d texture by sparse storage, of which only the
+   * pages that shaders actually sample are committed and streamed in.
+   *
+   * Shaders report sampled pages by writing a non-zero value to feedback()[page], where pages
+   * are laid out level by level, row-major, starting at page_offset(level). They may test
+   * page_table()[page] for residency, and fall back on coarser levels if it is zero; levels
+   * from sparse_levels() onwards form the mip tail, which is always resident.
+   *
+   * update() reads feedback without stalling, once the GPU has finished the frames that wrote
+   * it, then commits and streams requested pages, coarse levels first. Pages are evicted in
+   * least-recently-requested order to stay within the memory budget.
+   *
+   * The texture's size must be a multiple of page_size(); three-component formats generally
+   * have no sparse page sizes, and are rejected at compile time.
+   */
+  template <typename T, uint C>
+  class VirtualTexture {
+    static_assert(C != 3, "VirtualTexture: three-component formats have no sparse page sizes");
+
+    // Internal struct used for per-level page grids
+    struct LevelData {
+      eig::Array2u size;   // Level size, in texels
+      eig::Array2u pages;  // Page grid size
+      uint         offset; // Index of first page
+    };
+
+    // Internal struct used for pages
+    struct PageData {
+      uint64_t last_used   = 0;
+      bool     is_resident = false;
+    };
+
+    VirtualTextureInfo<T, C> m_info;
+    gl::Texture<T, 2, C>     m_texture;
+    gl::TextureStreamer      m_streamer;
+    eig::Array2u             m_page_size;
+    uint                     m_sparse_levels;
+    std::vector<LevelData>   m_levels;
+    std::vector<PageData>    m_pages;
+    std::vector<T>           m_page_data;     // Scratch space for the loader
+    std::vector<uint>        m_page_table_data;
+    gl::Buffer               m_page_table;
+    gl::Buffer               m_feedback;
+    std::span<const uint>    m_feedback_map;
+    sync::Fence              m_feedback_fence;
+    size_t                   m_resident_size = 0;
+    uint64_t                 m_frame         = 1;
+
+    // Page index to level and page coordinates, and page to texel region
+    std::pair<uint, eig::Array2u> page_coord(uint page) const;
+    std::pair<eig::Array2u, eig::Array2u> page_region(uint level, eig::Array2u coord) const;
+
+    // Commit and stream a single page; returns false if staging is full
+    bool load(uint page);
+
+    // Decommit the least-recently requested page not requested this frame; returns false if none
+    bool evict();
+
+  public:
+    using InfoType = VirtualTextureInfo<T, C>;
+
+    /* constr/destr */
+
+    VirtualTexture() = default;
+    VirtualTexture(InfoType info);
+
+    /* getters */
+
+    inline bool   is_init()       const { return m_texture.is_init(); }
+    inline size_t resident_size() const { return m_resident_size; }
+    inline uint   sparse_levels() const { return m_sparse_levels; }
+    inline uint   n_pages()       const { return static_cast<uint>(m_pages.size()); }
+    inline eig::Array2u page_size() const { return m_page_size; }
+    inline const gl::Texture<T, 2, C> &texture() const { return m_texture; }
+
+    // Page grid layout of a sparse level
+    inline uint         page_offset(uint level) const { return m_levels[level].offset; }
+    inline eig::Array2u page_grid(uint level)   const { return m_levels[level].pages; }
+
+    // Buffer of uint per page, written by shaders for sampled pages
+    inline const gl::Buffer &feedback()   const { return m_feedback; }
+
+    // Buffer of uint per page, non-zero for resident pages
+    inline const gl::Buffer &page_table() const { return m_page_table; }
+
+    /* residency */
+
+    // Process feedback, evict pages over budget, and commit and stream requested pages;
+    // call once per frame, after the passes that write feedback are submitted. Feedback is
+    // read with a latency of at least one frame, and requests accumulate until it is read
+    void update();
+
+    /* miscellaneous */
+
+    inline void swap(VirtualTexture &o) {
+      gl_trace();
+      using std::swap;
+      swap(m_info, o.m_info);
+      m_texture.swap(o.m_texture);
+      m_streamer.swap(o.m_streamer);
+      swap(m_page_size, o.m_page_size);
+      swap(m_sparse_levels, o.m_sparse_levels);
+      swap(m_levels, o.m_levels);
+      swap(m_pages, o.m_pages);
+      swap(m_page_data, o.m_page_data);
+      swap(m_page_table_data, o.m_page_table_data);
+      m_page_table.swap(o.m_page_table);
+      m_feedback.swap(o.m_feedback);
+      swap(m_feedback_map, o.m_feedback_map);
+      m_feedback_fence.swap(o.m_feedback_fence);
+      swap(m_resident_size, o.m_resident_size);
+      swap(m_frame, o.m_frame);
+    }
+
+    inline bool operator==(const VirtualTexture &o) const {
+      return m_texture == o.m_texture;
+    }
+
+    gl_declare_noncopyable(VirtualTexture);
+  };
+} // namespace gl
@@ -0,0 +1,120 @@
+#include <small_gl/async.hpp>
+#include <small_gl/utility.hpp>
+#include <small_gl/detail/trace.hpp>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <nlohmann/json.hpp>
+
+namespace gl {
+  AsyncWorker::AsyncWorker(AsyncWorkerInfo info)
+  : m_state(std::make_unique<StateData>()) {
+    gl_trace();
+    debug::check_expr(info.shared_context && info.shared_context->is_init(),
+      "AsyncWorker requires an initialized shared context");
+
+    // Create hidden window sharing the main context; must happen on the main thread.
+    // The swap interval is copied, as GLFW applies it to the current (main) context
+    WindowFlags flags = info.is_debug_context ? WindowFlags::eDebug : WindowFlags { };
+    m_context = {{ .size                  = { 1, 1 },
+                   .title                 = "small_gl async worker",
+                   .swap_interval         = info.shared_context->swap_interval(),
+                   .respect_content_scale = false,
+                   .profile_type          = info.profile_type,
+                   .profile_version_major = info.profile_version_major,
+                   .profile_version_minor = info.profile_version_minor,
+                   .is_main_context       = false,
+                   .shared_context        = info.shared_context,
+                   .flags                 = flags }};
+
+    // Spawn worker thread, which takes over the hidden context
+    m_thread = std::thread([state = m_state.get(), object = (GLFWwindow *) m_context.object()]() {
+      glfwMakeContextCurrent(object);
+      gl_trace_init_context();
+
+      while (true) {
+        JobType job;
+        {
+          std::unique_lock lock(state->mutex);
+          state->cv_jobs.wait(lock, [&] { return state->is_stopped || !state->jobs.empty(); });
+          guard_break(!state->jobs.empty());
+          job = std::move(state->jobs.front());
+          state->jobs.pop_front();
+          state->n_running++;
+        }
+
+        // Run job; jobs flush their own fences before handing them to other threads
+        job();
+
+        {
+          std::lock_guard lock(state->mutex);
+          state->n_running--;
+        }
+        state->cv_idle.notify_all();
+      }
+
+      glfwMakeContextCurrent(nullptr);
+    });
+  }
+
+  AsyncWorker::~AsyncWorker() {
+    gl_trace();
+    guard(m_state);
+
+    // Let the worker drain remaining jobs, then join before the hidden window is destroyed
+    {
+      std::lock_guard lock(m_state->mutex);
+      m_state->is_stopped = true;
+    }
+    m_state->cv_jobs.notify_all();
+    if (m_thread.joinable())
+      m_thread.join();
+  }
+
+  void AsyncWorker::push(JobType &&job) {
+    gl_trace();
+    debug::check_expr(m_state != nullptr, "attempt to use an uninitialized object");
+    {
+      std::lock_guard lock(m_state->mutex);
+      debug::check_expr(!m_state->is_stopped, "AsyncWorker::push(...) called on stopped worker");
+      m_state->jobs.push_back(std::move(job));
+    }
+    m_state->cv_jobs.notify_one();
+  }
+
+  AsyncResult<Buffer> AsyncWorker::upload_buffer(BufferInfo info) {
+    gl_trace();
+    std::vector<std::byte> data(range_iter(info.data));
+    return submit([info, data = std::move(data)]() mutable {
+      info.data = data;
+      return Buffer(info);
+    });
+  }
+
+  AsyncResult<Program> AsyncWorker::compile_program(std::vector<ShaderLoadFileInfo> info) {
+    gl_trace();
+    return submit([info = std::move(info)]() {
+      return Program(std::span<const ShaderLoadFileInfo>(info));
+    });
+  }
+
+  AsyncResult<Program> AsyncWorker::compile_program(std::vector<ShaderLoadStringInfo> info) {
+    gl_trace();
+    return submit([info = std::move(info)]() {
+      return Program(std::span<const ShaderLoadStringInfo>(info));
+    });
+  }
+
+  size_t AsyncWorker::n_pending() const {
+    gl_trace();
+    guard(m_state, 0);
+    std::lock_guard lock(m_state->mutex);
+    return m_state->jobs.size() + m_state->n_running;
+  }
+
+  void AsyncWorker::wait_idle() const {
+    gl_trace();
+    guard(m_state);
+    std::unique_lock lock(m_state->mutex);
+    m_state->cv_idle.wait(lock, [&] { return m_state->jobs.empty() && m_state->n_running == 0; });
+  }
+} // namespace gl
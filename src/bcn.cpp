@@ -0,0 +1,381 @@
+#include <small_gl/bcn.hpp>
+#include <small_gl/compressed_texture.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <optional>
+
+namespace gl {
+  namespace detail {
+    // 4x4 block of texels, as floats in [0, 255]
+    using BCnBlock = std::array<eig::Array4f, 16>;
+
+    // Pair of endpoints, and weight of the second endpoint per texel
+    using BCnEndpoints = std::pair<eig::Array4f, eig::Array4f>;
+    using BCnWeights   = std::array<float, 16>;
+
+    // BC7 4-bit index interpolation weights, in 64ths
+    constexpr std::array<uint, 16> bc7_weights = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    // Little-endian writer of up to 128 bits
+    struct BCnBitWriter {
+      std::array<uint64_t, 2> bits = { 0, 0 };
+      uint                    pos  = 0;
+
+      void write(uint64_t v, uint n) {
+        uint i = pos / 64, s = pos % 64;
+        bits[i] |= v << s;
+        if (s > 0 && s + n > 64)
+          bits[i + 1] |= v >> (64 - s);
+        pos += n;
+      }
+    };
+
+    // Load a block at block coordinates, clamping reads to the image's edge
+    BCnBlock bcn_load_block(std::span<const std::byte> data,
+                            const eig::Array2u        &size,
+                            uint                       components,
+                            uint                       bx,
+                            uint                       by) {
+      BCnBlock block;
+      for (uint y = 0; y < 4; ++y) {
+        for (uint x = 0; x < 4; ++x) {
+          uint sx = std::min(bx * 4 + x, size.x() - 1),
+               sy = std::min(by * 4 + y, size.y() - 1);
+          const std::byte *texel = data.data() + (static_cast<size_t>(sy) * size.x() + sx) * components;
+
+          eig::Array4f v = { 0.f, 0.f, 0.f, 255.f };
+          for (uint c = 0; c < components; ++c)
+            v[c] = static_cast<float>(std::to_integer<uint>(texel[c]));
+          block[y * 4 + x] = v;
+        }
+      }
+      return block;
+    }
+
+    // Fit endpoints along the block's principal axis, by power iteration over its covariance;
+    // endpoints are inset slightly, as extremes are rarely worth an index of their own
+    BCnEndpoints bcn_fit_principal(const BCnBlock &block, const eig::Array4f &mask) {
+      eig::Array4f mean = eig::Array4f::Zero();
+      for (const auto &v : block)
+        mean += v * mask;
+      mean /= 16.f;
+
+      eig::Matrix4f cov = eig::Matrix4f::Zero();
+      for (const auto &v : block) {
+        eig::Vector4f d = ((v * mask) - mean).matrix();
+        cov += d * d.transpose();
+      }
+
+      // Seed power iteration with the covariance column of largest variance; a constant seed
+      // may be orthogonal to the principal axis, e.g. on an equal-luminance red/green checker
+      eig::Index i_max;
+      guard(cov.diagonal().maxCoeff(&i_max) >= 1e-6f, BCnEndpoints { mean, mean });
+      eig::Vector4f axis = cov.col(i_max).normalized();
+      for (uint i = 0; i < 8; ++i) {
+        axis = cov * axis;
+        float norm = axis.norm();
+        if (norm < 1e-6f)
+          return { mean, mean };
+        axis /= norm;
+      }
+
+      float t_min = std::numeric_limits<float>::max(), t_max = std::numeric_limits<float>::lowest();
+      for (const auto &v : block) {
+        float t = ((v * mask) - mean).matrix().dot(axis);
+        t_min = std::min(t_min, t);
+        t_max = std::max(t_max, t);
+      }
+
+      eig::Array4f e0 = mean + t_min * axis.array(),
+                   e1 = mean + t_max * axis.array();
+      eig::Array4f inset = (e1 - e0) / 16.f;
+      return { (e0 + inset).cwiseMax(0.f).cwiseMin(255.f),
+               (e1 - inset).cwiseMax(0.f).cwiseMin(255.f) };
+    }
+
+    // Refit endpoints by least squares, given each texel's interpolation weight; only texels
+    // with set flags participate. Returns std::nullopt if the system is degenerate
+    std::optional<BCnEndpoints> bcn_fit_least_squares(const BCnBlock        &block,
+                                                      const BCnWeights      &weights,
+                                                      const std::array<bool, 16> &flags) {
+      float aa = 0.f, ab = 0.f, bb = 0.f;
+      eig::Array4f ax = eig::Array4f::Zero(), bx = eig::Array4f::Zero();
+      for (uint i = 0; i < 16; ++i) {
+        if (!flags[i])
+          continue;
+        float b = weights[i], a = 1.f - b;
+        aa += a * a; ab += a * b; bb += b * b;
+        ax += a * block[i];
+        bx += b * block[i];
+      }
+
+      float det = aa * bb - ab * ab;
+      guard(std::abs(det) > 1e-6f, std::nullopt);
+      eig::Array4f e0 = (bb * ax - ab * bx) / det,
+                   e1 = (aa * bx - ab * ax) / det;
+      return BCnEndpoints { e0.cwiseMax(0.f).cwiseMin(255.f), e1.cwiseMax(0.f).cwiseMin(255.f) };
+    }
+
+    // Nearest palette entry over a given nr. of entries, by squared distance under a mask
+    template <size_t N>
+    std::pair<uint, float> bcn_nearest(const eig::Array4f                &v,
+                                       const std::array<eig::Array4f, N> &palette,
+                                       uint                               n,
+                                       const eig::Array4f                &mask) {
+      uint  best_i = 0;
+      float best_e = std::numeric_limits<float>::max();
+      for (uint i = 0; i < n; ++i) {
+        float e = ((v - palette[i]) * mask).square().sum();
+        if (e < best_e) {
+          best_i = i;
+          best_e = e;
+        }
+      }
+      return { best_i, best_e };
+    }
+
+    /* BC1 */
+
+    uint bc1_quantize(const eig::Array4f &v) {
+      uint r = static_cast<uint>(std::round(v.x() * 31.f / 255.f)),
+           g = static_cast<uint>(std::round(v.y() * 63.f / 255.f)),
+           b = static_cast<uint>(std::round(v.z() * 31.f / 255.f));
+      return (r << 11) | (g << 5) | b;
+    }
+
+    eig::Array4f bc1_expand(uint c) {
+      uint r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+      return { static_cast<float>((r << 3) | (r >> 2)),
+               static_cast<float>((g << 2) | (g >> 4)),
+               static_cast<float>((b << 3) | (b >> 2)),
+               255.f };
+    }
+
+    // Encode a BC1 block from given endpoints; returns squared error, and weights per texel
+    float bc1_encode(const BCnBlock           &block,
+                     const std::array<bool, 16> &opaque,
+                     bool                        has_transparent,
+                     const BCnEndpoints         &endpoints,
+                     std::byte                  *out,
+                     BCnWeights                 &weights) {
+      const eig::Array4f mask = { 1.f, 1.f, 1.f, 0.f };
+
+      // Four-color mode requires c0 > c1, three-color mode with transparency c0 <= c1
+      uint c0 = bc1_quantize(endpoints.first), c1 = bc1_quantize(endpoints.second);
+      bool is_swapped = has_transparent ? c0 > c1 : c0 < c1;
+      if (is_swapped)
+        std::swap(c0, c1);
+
+      std::array<eig::Array4f, 4> palette;
+      std::array<float, 4>        palette_weights;
+      palette[0] = bc1_expand(c0);
+      palette[1] = bc1_expand(c1);
+      if (c0 > c1) {
+        palette[2] = (2.f * palette[0] + palette[1]) / 3.f;
+        palette[3] = (palette[0] + 2.f * palette[1]) / 3.f;
+        palette_weights = { 0.f, 1.f, 1.f / 3.f, 2.f / 3.f };
+      } else {
+        palette[2] = (palette[0] + palette[1]) / 2.f;
+        palette_weights = { 0.f, 1.f, .5f, 0.f };
+      }
+      uint n_palette = c0 > c1 ? 4 : 3;
+
+      uint32_t indices = 0;
+      float    error   = 0.f;
+      for (uint i = 0; i < 16; ++i) {
+        uint index = 3;
+        if (opaque[i]) {
+          auto [j, e] = bcn_nearest(block[i], palette, n_palette, mask);
+          index  = j;
+          error += e;
+        }
+        indices |= index << (2 * i);
+
+        // Report weights relative to the unswapped endpoints
+        float w = palette_weights[index];
+        weights[i] = is_swapped ? 1.f - w : w;
+      }
+
+      uint16_t c0_16 = static_cast<uint16_t>(c0), c1_16 = static_cast<uint16_t>(c1);
+      std::memcpy(out,     &c0_16,   2);
+      std::memcpy(out + 2, &c1_16,   2);
+      std::memcpy(out + 4, &indices, 4);
+      return error;
+    }
+
+    void bc1_encode_block(const BCnBlock &block, const BCnEncodeInfo &info, std::byte *out) {
+      std::array<bool, 16> opaque;
+      bool has_transparent = false;
+      for (uint i = 0; i < 16; ++i) {
+        opaque[i] = block[i].w() >= static_cast<float>(info.alpha_threshold);
+        has_transparent |= !opaque[i];
+      }
+
+      auto       endpoints = bcn_fit_principal(block, { 1.f, 1.f, 1.f, 0.f });
+      BCnWeights weights;
+      float      error = bc1_encode(block, opaque, has_transparent, endpoints, out, weights);
+      guard(info.is_refined && error > 0.f);
+
+      // Keep refined encoding only if it improves on the initial one
+      auto refined = bcn_fit_least_squares(block, weights, opaque);
+      guard(refined);
+      std::array<std::byte, 8> refined_out;
+      if (bc1_encode(block, opaque, has_transparent, *refined, refined_out.data(), weights) < error)
+        std::memcpy(out, refined_out.data(), refined_out.size());
+    }
+
+    /* BC4/BC5 */
+
+    // Encode a single channel of a block as a BC4 block, using the eight-value mode
+    void bc4_encode_block(const BCnBlock &block, uint channel, std::byte *out) {
+      float lo = 255.f, hi = 0.f;
+      for (const auto &v : block) {
+        lo = std::min(lo, v[channel]);
+        hi = std::max(hi, v[channel]);
+      }
+
+      uint e0 = static_cast<uint>(std::round(hi)), e1 = static_cast<uint>(std::round(lo));
+      uint64_t bits = static_cast<uint64_t>(e0) | (static_cast<uint64_t>(e1) << 8);
+
+      // Palette runs from e1 (j = 0) to e0 (j = 7); index 0 holds e0, 1 holds e1, and 2..7
+      // hold interpolants in order of decreasing value
+      if (e0 > e1) {
+        float scale = 7.f / static_cast<float>(e0 - e1);
+        for (uint i = 0; i < 16; ++i) {
+          uint j = static_cast<uint>(std::clamp(std::round((block[i][channel] - e1) * scale), 0.f, 7.f));
+          uint index = j == 7 ? 0 : j == 0 ? 1 : 8 - j;
+          bits |= static_cast<uint64_t>(index) << (16 + 3 * i);
+        }
+      }
+
+      std::memcpy(out, &bits, 8);
+    }
+
+    /* BC7 */
+
+    // Quantize an endpoint to 7 bits per channel plus a shared p-bit, choosing the p-bit
+    // that minimizes error
+    std::pair<eig::Array4u, uint> bc7_quantize(const eig::Array4f &v) {
+      std::pair<eig::Array4u, uint> best;
+      float best_e = std::numeric_limits<float>::max();
+      for (uint p = 0; p < 2; ++p) {
+        eig::Array4f q = ((v - static_cast<float>(p)) / 2.f).round().cwiseMax(0.f).cwiseMin(127.f);
+        float e = (q * 2.f + static_cast<float>(p) - v).square().sum();
+        if (e < best_e) {
+          best   = { q.cast<uint>(), p };
+          best_e = e;
+        }
+      }
+      return best;
+    }
+
+    // Encode a BC7 block from given endpoints in mode 6; a single subset with 7777.1 RGBA
+    // endpoints and 4-bit indices. Returns squared error, and weights per texel
+    float bc7_encode(const BCnBlock &block, const BCnEndpoints &endpoints, std::byte *out, BCnWeights &weights) {
+      const eig::Array4f mask = eig::Array4f::Ones();
+
+      auto [q0, p0] = bc7_quantize(endpoints.first);
+      auto [q1, p1] = bc7_quantize(endpoints.second);
+      eig::Array4u e0 = q0 * 2 + p0, e1 = q1 * 2 + p1;
+
+      std::array<eig::Array4f, 16> palette;
+      for (uint i = 0; i < 16; ++i)
+        palette[i] = ((e0 * (64 - bc7_weights[i]) + e1 * bc7_weights[i] + 32) / 64).cast<float>();
+
+      std::array<uint, 16> indices;
+      float error = 0.f;
+      for (uint i = 0; i < 16; ++i) {
+        auto [j, e] = bcn_nearest(block[i], palette, 16, mask);
+        indices[i] = j;
+        weights[i] = static_cast<float>(bc7_weights[j]) / 64.f;
+        error += e;
+      }
+
+      // The anchor index's top bit is implicitly zero; swap endpoints and invert indices if set
+      if (indices[0] & 8) {
+        std::swap(q0, q1);
+        std::swap(p0, p1);
+        for (auto &index : indices)
+          index = 15 - index;
+      }
+
+      BCnBitWriter writer;
+      writer.write(1 << 6, 7); // Mode 6
+      for (uint c = 0; c < 4; ++c) {
+        writer.write(q0[c], 7);
+        writer.write(q1[c], 7);
+      }
+      writer.write(p0, 1);
+      writer.write(p1, 1);
+      writer.write(indices[0], 3);
+      for (uint i = 1; i < 16; ++i)
+        writer.write(indices[i], 4);
+
+      std::memcpy(out, writer.bits.data(), 16);
+      return error;
+    }
+
+    void bc7_encode_block(const BCnBlock &block, const BCnEncodeInfo &info, std::byte *out) {
+      auto       endpoints = bcn_fit_principal(block, eig::Array4f::Ones());
+      BCnWeights weights;
+      float      error = bc7_encode(block, endpoints, out, weights);
+      guard(info.is_refined && error > 0.f);
+
+      // Keep refined encoding only if it improves on the initial one
+      std::array<bool, 16> flags;
+      flags.fill(true);
+      auto refined = bcn_fit_least_squares(block, weights, flags);
+      guard(refined);
+      std::array<std::byte, 16> refined_out;
+      if (bc7_encode(block, *refined, refined_out.data(), weights) < error)
+        std::memcpy(out, refined_out.data(), refined_out.size());
+    }
+  } // namespace detail
+
+  std::vector<std::byte> encode_bcn(std::span<const std::byte> data, eig::Array2u size, BCnEncodeInfo info) {
+    gl_trace();
+    debug::check_expr(info.components >= 1 && info.components <= 4,
+      "encode_bcn(...) requires one to four input components");
+    debug::check_expr(data.size() >= static_cast<size_t>(size.prod()) * info.components,
+      "encode_bcn(...) input data span is too small for image size");
+    debug::check_expr(info.format != CompressedFormat::eBC4Signed
+                   && info.format != CompressedFormat::eBC5Signed
+                   && info.format != CompressedFormat::eBC6H
+                   && info.format != CompressedFormat::eBC6HSigned,
+      "encode_bcn(...) cannot encode signed or floating point formats");
+    guard((size > 0u).all(), { });
+
+    eig::Array2u n_blocks   = (size + 3u) / 4u;
+    uint         block_size = detail::compressed_block_size(info.format);
+    std::vector<std::byte> blocks(static_cast<size_t>(n_blocks.prod()) * block_size);
+
+    #pragma omp parallel for
+    for (int by = 0; by < static_cast<int>(n_blocks.y()); ++by) {
+      for (uint bx = 0; bx < n_blocks.x(); ++bx) {
+        auto block = detail::bcn_load_block(data, size, info.components, bx, by);
+        auto out   = blocks.data() + (static_cast<size_t>(by) * n_blocks.x() + bx) * block_size;
+        switch (info.format) {
+          case CompressedFormat::eBC1:
+          case CompressedFormat::eBC1Srgb:
+            detail::bc1_encode_block(block, info, out);
+            break;
+          case CompressedFormat::eBC4:
+            detail::bc4_encode_block(block, 0, out);
+            break;
+          case CompressedFormat::eBC5:
+            detail::bc4_encode_block(block, 0, out);
+            detail::bc4_encode_block(block, 1, out + 8);
+            break;
+          default: // BC7 and BC7 sRGB
+            detail::bc7_encode_block(block, info, out);
+            break;
+        }
+      }
+    }
+
+    return blocks;
+  }
+} // namespace gl
@@ -0,0 +1,240 @@
+#include <small_gl/binding_set.hpp>
+#include <small_gl/buffer.hpp>
+#include <small_gl/sampler.hpp>
+#include <small_gl/texture.hpp>
+#include <small_gl/utility.hpp>
+#include <algorithm>
+
+namespace gl {
+  namespace detail {
+    // Test if a texture can be bound through glBindImageTextures with the same result as 
+    // Program::bind(...); that is, its internal format is a valid image unit format, and its
+    // target is not layered, as multi-bind binds all layers
+    bool is_batchable_image(const gl::AbstractTexture &texture) {
+      switch (texture.target()) {
+        case GL_TEXTURE_1D: case GL_TEXTURE_2D: case GL_TEXTURE_RECTANGLE: case GL_TEXTURE_BUFFER:
+          break;
+        default:
+          return false;
+      }
+      switch (texture.internal_format()) {
+        case GL_RGBA32F:      case GL_RGBA16F:      case GL_RG32F:        case GL_RG16F:
+        case GL_R11F_G11F_B10F:                     case GL_R32F:         case GL_R16F:
+        case GL_RGBA32UI:     case GL_RGBA16UI:     case GL_RGB10_A2UI:   case GL_RGBA8UI:
+        case GL_RG32UI:       case GL_RG16UI:       case GL_RG8UI:        case GL_R32UI:
+        case GL_R16UI:        case GL_R8UI:         case GL_RGBA32I:      case GL_RGBA16I:
+        case GL_RGBA8I:       case GL_RG32I:        case GL_RG16I:        case GL_RG8I:
+        case GL_R32I:         case GL_R16I:         case GL_R8I:          case GL_RGBA16:
+        case GL_RGB10_A2:     case GL_RGBA8:        case GL_RG16:         case GL_RG8:
+        case GL_R16:          case GL_R8:           case GL_RGBA16_SNORM: case GL_RGBA8_SNORM:
+        case GL_RG16_SNORM:   case GL_RG8_SNORM:    case GL_R16_SNORM:    case GL_R8_SNORM:
+          return true;
+        default:
+          return false;
+      }
+    }
+
+    // Find runs of contiguous, requested binding points that contain changed bindings, and
+    // call f(first, count) for each; unchanged bindings inside a run are rebound as well
+    template <typename T, typename F>
+    void commit_runs(std::vector<T> &pending, std::vector<T> &committed, F f) {
+      gl_trace_full();
+      committed.resize(pending.size());
+
+      auto is_dirty = [&](uint i) { return pending[i].is_set && pending[i] != committed[i]; };
+      for (uint i = 0; i < pending.size();) {
+        if (!is_dirty(i)) {
+          ++i;
+          continue;
+        }
+
+        uint first = i, last = i;
+        for (uint j = i + 1; j < pending.size() && pending[j].is_set; ++j)
+          if (is_dirty(j))
+            last = j;
+
+        f(first, last - first + 1);
+        std::copy(pending.begin() + first, pending.begin() + last + 1, committed.begin() + first);
+        i = last + 1;
+      }
+    }
+  } // namespace detail
+
+  BindingSet::BindingSet(Program &program)
+  : m_program(&program) {
+    gl_trace();
+  }
+
+  void BindingSet::bind(std::string_view s, const gl::AbstractTexture &texture, const gl::Sampler &sampler) {
+    gl_trace_full();
+    bind(m_program->handle(s), texture, sampler);
+  }
+
+  void BindingSet::bind(std::string_view s, const gl::AbstractTexture &texture) {
+    gl_trace_full();
+    bind(m_program->handle(s), texture);
+  }
+
+  void BindingSet::bind(std::string_view s, const gl::Sampler &sampler) {
+    gl_trace_full();
+    bind(m_program->handle(s), sampler);
+  }
+
+  void BindingSet::bind(std::string_view s, const gl::Buffer &buffer, size_t size, size_t offset) {
+    gl_trace_full();
+    bind(m_program->handle(s), buffer, size, offset);
+  }
+
+  void BindingSet::bind(const BindingHandle &data, const gl::AbstractTexture &texture, const gl::Sampler &sampler) {
+    gl_trace_full();
+    if (data.type != BindingType::eSampler)
+      debug::check_expr(false,
+        fmt::format("BindingSet::bind(...) failed with type mismatch for texture at binding: {}", data.binding));
+
+    m_textures.set(data.binding, { .object = texture.object(), .is_set = true });
+    m_samplers.set(data.binding, { .object = sampler.object(), .is_set = true });
+  }
+
+  void BindingSet::bind(const BindingHandle &data, const gl::AbstractTexture &texture) {
+    gl_trace_full();
+    if (data.type != BindingType::eSampler && data.type != BindingType::eImage)
+      debug::check_expr(false,
+        fmt::format("BindingSet::bind(...) failed with type mismatch for texture at binding: {}", data.binding));
+
+    if (data.type == BindingType::eSampler) {
+      m_textures.set(data.binding, { .object = texture.object(), .is_set = true });
+    } else if (data.access == BindingAccess::eReadWrite && detail::is_batchable_image(texture)) {
+      m_images.set(data.binding, { .object = texture.object(), .is_set = true });
+    } else {
+      // Restricted access, layered textures, and formats that are not valid image formats 
+      // cannot be batched; bind directly as Program::bind(...) does, and mark binding point 
+      // as unknown
+      auto target = data.access == BindingAccess::eReadOnly  ? gl::TextureTargetType::eImageReadOnly
+                  : data.access == BindingAccess::eWriteOnly ? gl::TextureTargetType::eImageWriteOnly
+                                                             : gl::TextureTargetType::eImageReadWrite;
+      texture.bind_to(target, data.binding, 0);
+      m_images.set(data.binding, { });
+      if (m_images.committed.size() > static_cast<size_t>(data.binding))
+        m_images.committed[data.binding] = { };
+    }
+  }
+
+  void BindingSet::bind(const BindingHandle &data, const gl::Sampler &sampler) {
+    gl_trace_full();
+    if (data.type != BindingType::eSampler)
+      debug::check_expr(false,
+        fmt::format("BindingSet::bind(...) failed with type mismatch for sampler at binding: {}", data.binding));
+
+    m_samplers.set(data.binding, { .object = sampler.object(), .is_set = true });
+  }
+
+  void BindingSet::bind(const BindingHandle &data, const gl::Buffer &buffer, size_t size, size_t offset) {
+    gl_trace_full();
+    if (data.type != BindingType::eUniformBuffer && data.type != BindingType::eStorageBuffer)
+      debug::check_expr(false,
+        fmt::format("BindingSet::bind(...) failed with type mismatch for buffer at binding: {}", data.binding));
+    debug::check_expr(buffer.is_init(), "attempt to use an uninitialized object");
+
+    BufferData buffer_data = { .object = buffer.object(),
+                               .offset = offset,
+                               .size   = (size == 0) ? buffer.size() : size,
+                               .is_set = true };
+    if (data.type == BindingType::eUniformBuffer)
+      m_uniform_buffers.set(data.binding, buffer_data);
+    else
+      m_storage_buffers.set(data.binding, buffer_data);
+  }
+
+  void BindingSet::commit() {
+    gl_trace_full();
+    debug::check_expr(is_init(), "attempt to use an uninitialized object");
+
+    // Fall back on individual binds if multi-bind is unavailable
+    bool is_multi_bind = GLAD_GL_ARB_multi_bind;
+
+    // Buffer runs; offsets and sizes are converted to the types expected by GL
+    std::vector<uint>       objects;
+    std::vector<GLintptr>   offsets;
+    std::vector<GLsizeiptr> sizes;
+    auto commit_buffers = [&](NamespaceData<BufferData> &data, uint target) {
+      detail::commit_runs(data.pending, data.committed, [&](uint first, uint count) {
+        if (!is_multi_bind) {
+          for (uint i = first; i < first + count; ++i) {
+            const auto &b = data.pending[i];
+            glBindBufferRange(target, i, b.object, b.offset, b.size);
+          }
+          return;
+        }
+
+        objects.resize(count);
+        offsets.resize(count);
+        sizes.resize(count);
+        for (uint i = 0; i < count; ++i) {
+          const auto &b = data.pending[first + i];
+          objects[i] = b.object;
+          offsets[i] = static_cast<GLintptr>(b.offset);
+          sizes[i]   = static_cast<GLsizeiptr>(b.size);
+        }
+        glBindBuffersRange(target, first, count, objects.data(), offsets.data(), sizes.data());
+      });
+    };
+
+    // Texture, sampler and image runs
+    auto gather_objects = [&](const NamespaceData<ObjectData> &data, uint first, uint count) {
+      objects.resize(count);
+      for (uint i = 0; i < count; ++i)
+        objects[i] = data.pending[first + i].object;
+    };
+
+    commit_buffers(m_uniform_buffers, GL_UNIFORM_BUFFER);
+    commit_buffers(m_storage_buffers, GL_SHADER_STORAGE_BUFFER);
+    detail::commit_runs(m_textures.pending, m_textures.committed, [&](uint first, uint count) {
+      gather_objects(m_textures, first, count);
+      if (is_multi_bind) {
+        glBindTextures(first, count, objects.data());
+      } else {
+        for (uint i = 0; i < count; ++i)
+          glBindTextureUnit(first + i, objects[i]);
+      }
+    });
+    detail::commit_runs(m_samplers.pending, m_samplers.committed, [&](uint first, uint count) {
+      gather_objects(m_samplers, first, count);
+      if (is_multi_bind) {
+        glBindSamplers(first, count, objects.data());
+      } else {
+        for (uint i = 0; i < count; ++i)
+          glBindSampler(first + i, objects[i]);
+      }
+    });
+    detail::commit_runs(m_images.pending, m_images.committed, [&](uint first, uint count) {
+      gather_objects(m_images, first, count);
+      if (is_multi_bind) {
+        glBindImageTextures(first, count, objects.data());
+      } else {
+        for (uint i = 0; i < count; ++i) {
+          GLint internal_format;
+          glGetTextureLevelParameteriv(objects[i], 0, GL_TEXTURE_INTERNAL_FORMAT, &internal_format);
+          glBindImageTexture(first + i, objects[i], 0, GL_FALSE, 0, GL_READ_WRITE, internal_format);
+        }
+      }
+    });
+  }
+
+  void BindingSet::invalidate() {
+    gl_trace();
+    m_uniform_buffers.committed.clear();
+    m_storage_buffers.committed.clear();
+    m_textures.committed.clear();
+    m_samplers.committed.clear();
+    m_images.committed.clear();
+  }
+
+  void BindingSet::clear() {
+    gl_trace();
+    m_uniform_buffers = { };
+    m_storage_buffers = { };
+    m_textures        = { };
+    m_samplers        = { };
+    m_images          = { };
+  }
+} // namespace gl
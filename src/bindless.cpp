@@ -0,0 +1,218 @@
+#include <small_gl/bindless.hpp>
+#include <small_gl/sampler.hpp>
+#include <small_gl/texture.hpp>
+#include <small_gl/utility.hpp>
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+namespace gl {
+  namespace detail {
+    // Estimate the size of all levels of a texture, in bytes, from its level parameters
+    size_t texture_size_estimate(uint object, uint levels) {
+      gl_trace();
+
+      size_t size = 0;
+      for (uint level = 0; level < std::max(levels, 1u); ++level) {
+        int is_compressed = 0;
+        glGetTextureLevelParameteriv(object, level, GL_TEXTURE_COMPRESSED, &is_compressed);
+        if (is_compressed) {
+          int compressed_size = 0;
+          glGetTextureLevelParameteriv(object, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &compressed_size);
+          size += compressed_size;
+          continue;
+        }
+
+        std::array<int, 3> dims = { 1, 1, 1 };
+        glGetTextureLevelParameteriv(object, level, GL_TEXTURE_WIDTH,  &dims[0]);
+        glGetTextureLevelParameteriv(object, level, GL_TEXTURE_HEIGHT, &dims[1]);
+        glGetTextureLevelParameteriv(object, level, GL_TEXTURE_DEPTH,  &dims[2]);
+
+        int bits = 0;
+        for (auto param : { GL_TEXTURE_RED_SIZE,   GL_TEXTURE_GREEN_SIZE, GL_TEXTURE_BLUE_SIZE,
+                            GL_TEXTURE_ALPHA_SIZE, GL_TEXTURE_DEPTH_SIZE, GL_TEXTURE_STENCIL_SIZE }) {
+          int component_bits = 0;
+          glGetTextureLevelParameteriv(object, level, param, &component_bits);
+          bits += component_bits;
+        }
+
+        size += static_cast<size_t>(dims[0]) * dims[1] * dims[2] * ((bits + 7) / 8);
+      }
+      return size;
+    }
+  } // namespace detail
+
+  bool is_bindless_supported() {
+    gl_trace();
+    return GLAD_GL_ARB_bindless_texture;
+  }
+
+  uint64_t texture_handle(const gl::AbstractTexture &texture) {
+    gl_trace();
+    debug::check_expr(is_bindless_supported(), "texture_handle(...) requires ARB_bindless_texture");
+    debug::check_expr(texture.is_init(), "attempt to use an uninitialized object");
+    return glGetTextureHandleARB(texture.object());
+  }
+
+  uint64_t texture_handle(const gl::AbstractTexture &texture, const gl::Sampler &sampler) {
+    gl_trace();
+    debug::check_expr(is_bindless_supported(), "texture_handle(...) requires ARB_bindless_texture");
+    debug::check_expr(texture.is_init() && sampler.is_init(), "attempt to use an uninitialized object");
+    return glGetTextureSamplerHandleARB(texture.object(), sampler.object());
+  }
+
+  ResidencyManager::ResidencyManager(ResidencyManagerInfo info)
+  : m_info(info),
+    m_is_bindless(is_bindless_supported()),
+    m_slots(info.max_textures) {
+    gl_trace();
+    debug::check_expr(info.max_textures > 0, "ResidencyManager requires at least one slot");
+
+    // Free slots are handed out lowest-first
+    m_free_slots.resize(info.max_textures);
+    std::iota(m_free_slots.rbegin(), m_free_slots.rend(), 0u);
+
+    std::vector<uint64_t> table(info.max_textures, 0);
+    m_table = {{ .size  = table.size() * sizeof(uint64_t),
+                 .data  = std::as_bytes(std::span(table)),
+                 .flags = BufferCreateFlags::eStorageDynamic }};
+
+    if (!m_is_bindless)
+      debug::insert_message("ResidencyManager: ARB_bindless_texture unavailable, falling back on texture units",
+        gl::DebugMessageSeverity::eLow);
+  }
+
+  ResidencyManager::~ResidencyManager() {
+    gl_trace();
+    guard(is_init());
+    for (auto &slot : m_slots)
+      make_non_resident(slot);
+  }
+
+  void ResidencyManager::make_resident(SlotData &slot) {
+    gl_trace();
+    guard(m_is_bindless && slot.handle && !slot.is_resident);
+    slot.is_resident = true;
+
+    // Slots may share a handle, e.g. materials sharing a texture; it is made resident once
+    if (m_handle_counts[slot.handle]++ == 0) {
+      glMakeTextureHandleResidentARB(slot.handle);
+      m_resident_size += slot.size;
+    }
+  }
+
+  void ResidencyManager::make_non_resident(SlotData &slot) {
+    gl_trace();
+    guard(slot.is_resident);
+    slot.is_resident = false;
+
+    // Shared handles stay resident until no slot holds them resident
+    auto f = m_handle_counts.find(slot.handle);
+    guard(--f->second == 0);
+    m_handle_counts.erase(f);
+    glMakeTextureHandleNonResidentARB(slot.handle);
+    m_resident_size -= slot.size;
+  }
+
+  uint ResidencyManager::insert(const gl::AbstractTexture &texture) {
+    gl_trace();
+    debug::check_expr(is_init(), "attempt to use an uninitialized object");
+    debug::check_expr(!m_free_slots.empty(), "ResidencyManager::insert(...) failed; handle table is full");
+
+    uint i = m_free_slots.back();
+    m_free_slots.pop_back();
+
+    auto &slot = m_slots[i];
+    slot = { .texture    = texture.object(),
+             .size       = detail::texture_size_estimate(texture.object(), texture.levels()),
+             .last_frame = m_frame };
+    if (m_is_bindless) {
+      slot.handle = texture_handle(texture);
+      m_table.set(std::as_bytes(std::span(&slot.handle, 1)), sizeof(uint64_t), i * sizeof(uint64_t));
+    }
+    return i;
+  }
+
+  uint ResidencyManager::insert(const gl::AbstractTexture &texture, const gl::Sampler &sampler) {
+    gl_trace();
+    debug::check_expr(is_init(), "attempt to use an uninitialized object");
+    debug::check_expr(!m_free_slots.empty(), "ResidencyManager::insert(...) failed; handle table is full");
+
+    uint i = m_free_slots.back();
+    m_free_slots.pop_back();
+
+    auto &slot = m_slots[i];
+    slot = { .texture    = texture.object(),
+             .sampler    = sampler.object(),
+             .size       = detail::texture_size_estimate(texture.object(), texture.levels()),
+             .last_frame = m_frame };
+    if (m_is_bindless) {
+      slot.handle = texture_handle(texture, sampler);
+      m_table.set(std::as_bytes(std::span(&slot.handle, 1)), sizeof(uint64_t), i * sizeof(uint64_t));
+    }
+    return i;
+  }
+
+  void ResidencyManager::erase(uint i) {
+    gl_trace();
+    if (i >= m_slots.size() || !m_slots[i].texture)
+      debug::check_expr(false, fmt::format("ResidencyManager::erase(...) failed; slot {} is not in use", i));
+
+    auto &slot = m_slots[i];
+    make_non_resident(slot);
+    slot = { };
+    m_free_slots.push_back(i);
+
+    if (m_is_bindless) {
+      uint64_t zero = 0;
+      m_table.set(std::as_bytes(std::span(&zero, 1)), sizeof(uint64_t), i * sizeof(uint64_t));
+    }
+  }
+
+  void ResidencyManager::use(uint i) {
+    gl_trace_full();
+    if (i >= m_slots.size() || !m_slots[i].texture)
+      debug::check_expr(false, fmt::format("ResidencyManager::use(...) failed; slot {} is not in use", i));
+
+    auto &slot = m_slots[i];
+    slot.last_frame = m_frame;
+    slot.is_used    = true;
+    make_resident(slot);
+  }
+
+  void ResidencyManager::bind_to(uint i, uint unit) const {
+    gl_trace_full();
+    if (i >= m_slots.size() || !m_slots[i].texture)
+      debug::check_expr(false, fmt::format("ResidencyManager::bind_to(...) failed; slot {} is not in use", i));
+
+    const auto &slot = m_slots[i];
+    glBindTextureUnit(unit, slot.texture);
+    glBindSampler(unit, slot.sampler);
+  }
+
+  void ResidencyManager::end_frame() {
+    gl_trace();
+
+    // Make handles non-resident that have gone unused for too long
+    for (auto &slot : m_slots)
+      if (slot.is_resident && m_frame - slot.last_frame >= m_info.max_idle_frames)
+        make_non_resident(slot);
+
+    // Trim residency to budget in least-recently-used order, sparing this frame's handles
+    if (m_info.max_resident_size > 0 && m_resident_size > m_info.max_resident_size) {
+      std::vector<uint> candidates;
+      for (uint i = 0; i < m_slots.size(); ++i)
+        if (m_slots[i].is_resident && !m_slots[i].is_used)
+          candidates.push_back(i);
+      std::ranges::sort(candidates, {}, [&](uint i) { return m_slots[i].last_frame; });
+      for (uint i : candidates) {
+        guard_break(m_resident_size > m_info.max_resident_size);
+        make_non_resident(m_slots[i]);
+      }
+    }
+
+    for (auto &slot : m_slots)
+      slot.is_used = false;
+    m_frame++;
+  }
+} // namespace gl
@@ -0,0 +1,217 @@
+#include <small_gl/array.hpp>
+#include <small_gl/buffer.hpp>
+#include <small_gl/command.hpp>
+#include <small_gl/utility.hpp>
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+
+namespace gl {
+  namespace detail {
+    // Overload helper for std::visit
+    template <class... Ts>
+    struct visitor : Ts... { using Ts::operator()...; };
+
+    // Copy recorded state data back into a DrawInfo-like object; capabilities are handled separately
+    void copy_record_state(auto &info, const auto &state) {
+      info.draw_op              = state.draw_op;
+      info.logic_op             = state.logic_op;
+      info.cull_op              = state.cull_op;
+      info.depth_op             = state.depth_op;
+      info.blend_op             = state.blend_op;
+      info.bindable_array       = state.bindable_array;
+      info.bindable_program     = state.bindable_program;
+      info.bindable_framebuffer = state.bindable_framebuffer;
+    }
+  } // namespace detail
+
+  CommandBuffer::CommandBuffer(CommandBufferInfo info) {
+    gl_trace();
+    m_commands.reserve(info.reserve_commands);
+    m_data.reserve(info.reserve_data);
+  }
+
+  detail::StateRecord CommandBuffer::record_state(const auto &info) {
+    // Append capabilities to the arena
+    detail::CommandRange capabilities = { .offset = static_cast<uint>(m_capabilities.size()),
+                           .size   = static_cast<uint>(info.capabilities.size()) };
+    m_capabilities.insert(m_capabilities.end(), range_iter(info.capabilities));
+
+    return detail::StateRecord { .capabilities         = capabilities,
+                         .draw_op              = info.draw_op,
+                         .logic_op             = info.logic_op,
+                         .cull_op              = info.cull_op,
+                         .depth_op             = info.depth_op,
+                         .blend_op             = info.blend_op,
+                         .bindable_array       = info.bindable_array,
+                         .bindable_program     = info.bindable_program,
+                         .bindable_framebuffer = info.bindable_framebuffer };
+  }
+
+  void CommandBuffer::record(const DrawInfo &info, uint key) {
+    gl_trace();
+    debug::check_expr(info.bindable_array, "DrawInfo submitted without bindable array object");
+    m_commands.push_back({ key, detail::DrawRecord { .type           = info.type,
+                                             .vertex_count   = info.vertex_count,
+                                             .vertex_first   = info.vertex_first,
+                                             .instance_count = info.instance_count,
+                                             .vertex_base    = info.vertex_base,
+                                             .instance_base  = info.instance_base,
+                                             .state          = record_state(info) } });
+  }
+
+  void CommandBuffer::record(const DrawIndirectInfo &info, uint key) {
+    gl_trace();
+    debug::check_expr(info.bindable_array, "DrawIndirectInfo submitted without bindable array object");
+    m_commands.push_back({ key, detail::DrawIndirectRecord { .type   = info.type,
+                                                     .buffer = info.buffer,
+                                                     .state  = record_state(info) } });
+  }
+
+  void CommandBuffer::record(const MultiDrawInfo &info, uint key) {
+    gl_trace();
+    debug::check_expr(info.bindable_array, "MultiDrawInfo submitted without bindable array object");
+
+    // Append draw commands to the arena
+    detail::CommandRange commands = { .offset = static_cast<uint>(m_draw_commands.size()),
+                       .size   = static_cast<uint>(info.commands.size()) };
+    m_draw_commands.insert(m_draw_commands.end(), range_iter(info.commands));
+
+    m_commands.push_back({ key, detail::MultiDrawRecord { .type     = info.type,
+                                                  .commands = commands,
+                                                  .state    = record_state(info) } });
+  }
+
+  void CommandBuffer::record(const ComputeInfo &info, uint key) {
+    gl_trace();
+    m_commands.push_back({ key, detail::ComputeRecord { .groups_x         = info.groups_x,
+                                                .groups_y         = info.groups_y,
+                                                .groups_z         = info.groups_z,
+                                                .bindable_program = info.bindable_program } });
+  }
+
+  void CommandBuffer::record(const ComputeIndirectInfo &info, uint key) {
+    gl_trace();
+    m_commands.push_back({ key, detail::ComputeIndirectRecord { .buffer           = info.buffer,
+                                                        .bindable_program = info.bindable_program } });
+  }
+
+  void CommandBuffer::record_barrier(BarrierFlags flags, uint key) {
+    gl_trace();
+    m_commands.push_back({ key, detail::BarrierRecord { .flags = flags } });
+  }
+
+  void CommandBuffer::record_upload(Buffer &buffer, std::span<const std::byte> data, size_t offset, uint key) {
+    gl_trace();
+    debug::check_expr(data.size_bytes() > 0, "CommandBuffer::record_upload(...) submitted without data");
+
+    // Copy upload data into the arena
+    size_t data_offset = m_data.size();
+    m_data.resize(data_offset + data.size_bytes());
+    std::memcpy(m_data.data() + data_offset, data.data(), data.size_bytes());
+
+    m_commands.push_back({ key, detail::UploadRecord { .buffer        = &buffer,
+                                               .buffer_offset = offset,
+                                               .data_offset   = data_offset,
+                                               .data_size     = data.size_bytes() } });
+  }
+
+  void CommandBuffer::clear() {
+    gl_trace();
+    m_commands.clear();
+    m_capabilities.clear();
+    m_draw_commands.clear();
+    m_data.clear();
+  }
+
+  void CommandBuffer::dispatch(const Command &command, detail::CommandReplayState &replay) const {
+    gl_trace_full();
+
+    // Scoped capabilities are set up per command, as gl::dispatch_draw(...) would; the
+    // reused scratch vector restores previous state on clear() without reallocating
+    auto set_capabilities = [&](const detail::StateRecord &state) {
+      replay.scoped_state.clear();
+      auto capabilities = std::span(m_capabilities).subspan(state.capabilities.offset, state.capabilities.size);
+      for (auto [key, value] : capabilities)
+        replay.scoped_state.emplace_back(key, value);
+    };
+
+    std::visit(detail::visitor {
+      [&](const detail::DrawRecord &r) {
+        DrawInfo info = { .type           = r.type,
+                          .vertex_count   = r.vertex_count,
+                          .vertex_first   = r.vertex_first,
+                          .instance_count = r.instance_count,
+                          .vertex_base    = r.vertex_base,
+                          .instance_base  = r.instance_base };
+        detail::copy_record_state(info, r.state);
+        set_capabilities(r.state);
+        dispatch_draw(info);
+        replay.scoped_state.clear();
+      },
+      [&](const detail::DrawIndirectRecord &r) {
+        DrawIndirectInfo info = { .type = r.type, .buffer = r.buffer };
+        detail::copy_record_state(info, r.state);
+        set_capabilities(r.state);
+        dispatch_draw(info);
+        replay.scoped_state.clear();
+      },
+      [&](const detail::MultiDrawRecord &r) {
+        auto &info = replay.multidraw;
+        auto commands = std::span(m_draw_commands).subspan(r.commands.offset, r.commands.size);
+        info.type = r.type;
+        info.commands.assign(range_iter(commands));
+        detail::copy_record_state(info, r.state);
+        set_capabilities(r.state);
+        dispatch_multidraw(info);
+        replay.scoped_state.clear();
+      },
+      [&](const detail::ComputeRecord &r) {
+        dispatch_compute(ComputeInfo { .groups_x         = r.groups_x,
+                                       .groups_y         = r.groups_y,
+                                       .groups_z         = r.groups_z,
+                                       .bindable_program = r.bindable_program });
+      },
+      [&](const detail::ComputeIndirectRecord &r) {
+        dispatch_compute(ComputeIndirectInfo { .buffer           = r.buffer,
+                                               .bindable_program = r.bindable_program });
+      },
+      [&](const detail::BarrierRecord &r) {
+        sync::memory_barrier(r.flags);
+      },
+      [&](const detail::UploadRecord &r) {
+        auto data = std::span(m_data).subspan(r.data_offset, r.data_size);
+        r.buffer->set(data, r.data_size, r.buffer_offset);
+      }
+    }, command.record);
+  }
+
+  void dispatch_commands(std::span<const CommandBuffer> buffers) {
+    gl_trace_full();
+
+    // Gather (key, buffer, record) indices across buffers
+    using IndexType = std::tuple<uint, uint, uint>;
+    std::vector<IndexType> indices;
+    size_t n_commands = 0;
+    for (const auto &buffer : buffers)
+      n_commands += buffer.size();
+    indices.reserve(n_commands);
+    for (uint i = 0; i < buffers.size(); ++i) {
+      const auto &commands = buffers[i].m_commands;
+      for (uint j = 0; j < commands.size(); ++j)
+        indices.push_back({ commands[j].key, i, j });
+    }
+
+    // Establish deterministic replay order, independent of recording thread timing
+    std::ranges::sort(indices);
+
+    // Replay commands on the current context
+    detail::CommandReplayState replay;
+    for (auto [key, i, j] : indices)
+      buffers[i].dispatch(buffers[i].m_commands[j], replay);
+  }
+
+  void dispatch_commands(const CommandBuffer &buffer) {
+    dispatch_commands(std::span(&buffer, 1));
+  }
+} // namespace gl
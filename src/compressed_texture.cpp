@@ -0,0 +1,112 @@
+#include <small_gl/compressed_texture.hpp>
+#include <algorithm>
+
+namespace gl {
+  template <TextureType Ty>
+  CompressedTexture<Ty>::CompressedTexture(InfoType info)
+  : Base(true), m_levels(info.levels), m_size(info.size), m_format(info.format) {
+    gl_trace_full();
+    debug::check_expr((m_size >= vect(1)).all(), "texture size must be all >= 1");
+    debug::check_expr(m_levels >= 1,  "texture level must be >= 1");
+    debug::check_expr((m_format != CompressedFormat::eBC1 && m_format != CompressedFormat::eBC1Srgb) 
+                      || GLAD_GL_EXT_texture_compression_s3tc,
+      "BC1 texture requested, but EXT_texture_compression_s3tc is not supported");
+
+    glCreateTextures(detail::texture_target<2, Ty>(), 1, &m_object);
+
+    if constexpr (Ty == TextureType::eImage) {
+      glTextureStorage2D(m_object, m_levels, internal_format(), m_size.x(), m_size.y());
+    } else {
+      glTextureStorage3D(m_object, m_levels, internal_format(), m_size.x(), m_size.y(), m_size.z());
+    }
+
+    // If prior data was provided, upload it
+    if (info.data.data())
+      set(info.data);
+
+    // Estimate texture size in bytes
+#ifdef GL_ENABLE_TRACY
+    size_t alloc_size = detail::compressed_size(m_format, m_size);
+    for (size_t lvl_alloc_size = alloc_size, i = 1; i < static_cast<size_t>(m_levels); ++i) {
+      lvl_alloc_size /= 4;
+      alloc_size += lvl_alloc_size;
+    }
+#endif // GL_ENABLE_TRACY
+    gl_trace_gpu_alloc("gl::CompressedTexture", object(), alloc_size);
+  }
+
+  template <TextureType Ty>
+  CompressedTexture<Ty>::~CompressedTexture() {
+    guard(m_is_init);
+    gl_trace_gpu_free("gl::CompressedTexture", object());
+    glDeleteTextures(1, &m_object);
+  }
+
+  template <TextureType Ty>
+  size_t CompressedTexture<Ty>::compressed_size(uint level) const {
+    gl_trace_full();
+    int size = 0;
+    glGetTextureLevelParameteriv(m_object, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &size);
+    return static_cast<size_t>(size);
+  }
+
+  template <TextureType Ty>
+  void CompressedTexture<Ty>::get(std::span<std::byte> data, uint level) const {
+    gl_trace_full();
+    debug::check_expr(data.size() >= compressed_size(level),
+      "provided data span is too small for requested texture level to be written");
+    glGetCompressedTextureImage(m_object, level, data.size_bytes(), data.data());
+  }
+
+  template <TextureType Ty>
+  void CompressedTexture<Ty>::set(std::span<const std::byte> data, uint level, vect size, vect offset) {
+    gl_trace_full();
+
+    // Default to the full level; array layers do not shrink with level
+    vect safe_size = size;
+    if (safe_size.isZero()) {
+      safe_size = m_size;
+      safe_size.x() = std::max(1u, m_size.x() >> level);
+      safe_size.y() = std::max(1u, m_size.y() >> level);
+    }
+
+    const size_t size_bytes = detail::compressed_size(m_format, safe_size);
+    debug::check_expr(data.data() && data.size_bytes() >= size_bytes,
+      "provided data span is too small for requested texture region to be read");
+    debug::check_expr(offset.x() % 4 == 0 && offset.y() % 4 == 0,
+      "compressed texture region offset must be aligned to 4x4 blocks");
+
+    if constexpr (Ty == TextureType::eImage) {
+      glCompressedTextureSubImage2D(m_object, level,
+        offset.x(), offset.y(),
+        safe_size.x(), safe_size.y(),
+        internal_format(), size_bytes, data.data());
+    } else {
+      glCompressedTextureSubImage3D(m_object, level,
+        offset.x(), offset.y(), offset.z(),
+        safe_size.x(), safe_size.y(), safe_size.z(),
+        internal_format(), size_bytes, data.data());
+    }
+  }
+
+  template <TextureType Ty>
+  void CompressedTexture<Ty>::bind_to(TextureTargetType target, uint index, uint) const {
+    gl_trace_full();
+    debug::check_expr(target == TextureTargetType::eTextureUnit,
+      "compressed textures cannot be bound as images");
+    glBindTextureUnit(index, m_object);
+  }
+
+  template <TextureType Ty>
+  void CompressedTexture<Ty>::generate_mipmaps() {
+    gl_trace_full();
+    guard(m_levels > 1);
+    debug::check_expr(false,
+      "compressed textures cannot generate mipmaps; encode and upload each level instead");
+  }
+
+  /* Explicit template instantiations of gl::CompressedTexture<...> */
+
+  template class CompressedTexture<TextureType::eImage>;
+  template class CompressedTexture<TextureType::eImageArray>;
+} // namespace gl
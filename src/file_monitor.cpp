@@ -0,0 +1,140 @@
+#include <small_gl/detail/file_monitor.hpp>
+#include <small_gl/utility.hpp>
+#include <small_gl/detail/trace.hpp>
+#include <chrono>
+#ifdef __linux__
+  #include <poll.h>
+  #include <sys/inotify.h>
+  #include <unistd.h>
+#endif
+
+namespace gl::detail {
+  namespace {
+    // Interval at which the background thread checks for stop requests, or polls modification times
+    constexpr auto file_monitor_interval = std::chrono::milliseconds(100);
+  } // namespace
+
+  FileMonitor::FileMonitor(bool force_polling)
+  : m_state(std::make_unique<StateData>()) {
+    gl_trace();
+
+#ifdef __linux__
+    if (!force_polling)
+      m_state->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+
+    if (m_state->inotify_fd != -1) {
+      m_thread = std::thread(run_inotify, m_state.get());
+    } else {
+      m_thread = std::thread(run_polling, m_state.get());
+    }
+  }
+
+  FileMonitor::~FileMonitor() {
+    gl_trace();
+    guard(m_state);
+
+    m_state->is_stopped.store(true);
+    if (m_thread.joinable())
+      m_thread.join();
+
+#ifdef __linux__
+    if (m_state->inotify_fd != -1)
+      close(m_state->inotify_fd);
+#endif
+  }
+
+  bool FileMonitor::is_event_driven() const {
+    gl_trace();
+    return m_state && m_state->inotify_fd != -1;
+  }
+
+  uint FileMonitor::watch(const fs::path &file_path) {
+    gl_trace();
+    debug::check_expr(m_state != nullptr, "attempt to use an uninitialized object");
+    debug::check_expr(fs::exists(file_path),
+      fmt::format("failed to resolve path \"{}\"", file_path.string()));
+
+    auto path = fs::canonical(file_path);
+    std::lock_guard lock(m_state->mutex);
+
+    // Return existing id if the file is already watched
+    auto [it, is_new] = m_state->ids.emplace(path.string(), static_cast<uint>(m_state->paths.size()));
+    guard(is_new, it->second);
+    uint id = it->second;
+    m_state->paths.push_back(path);
+    m_state->times.push_back(fs::last_write_time(path));
+
+#ifdef __linux__
+    // Watch the parent directory, so files replaced by rename are still reported
+    if (m_state->inotify_fd != -1) {
+      auto dir = path.parent_path().string();
+      auto f   = m_state->dir_wds.find(dir);
+      if (f == m_state->dir_wds.end()) {
+        constexpr uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE;
+        int wd = inotify_add_watch(m_state->inotify_fd, dir.c_str(), mask);
+        debug::check_expr(wd != -1,
+          fmt::format("failed to watch directory \"{}\"", dir));
+        f = m_state->dir_wds.emplace(dir, wd).first;
+      }
+      m_state->dirs[f->second].push_back(id);
+    }
+#endif
+
+    return id;
+  }
+
+  void FileMonitor::run_inotify(StateData *state) {
+#ifdef __linux__
+    // Buffer aligned for inotify_event, fitting several events with file names
+    alignas(inotify_event) std::array<char, 16 * (sizeof(inotify_event) + 256)> buffer;
+
+    while (!state->is_stopped.load()) {
+      // Wait for events, or time out to test for stop requests
+      pollfd fd = { .fd = state->inotify_fd, .events = POLLIN, .revents = 0 };
+      int n = poll(&fd, 1, static_cast<int>(file_monitor_interval.count()));
+      guard_continue(n > 0 && (fd.revents & POLLIN));
+
+      ssize_t size = read(state->inotify_fd, buffer.data(), buffer.size());
+      guard_continue(size > 0);
+
+      std::lock_guard lock(state->mutex);
+      for (ssize_t i = 0; i < size; ) {
+        auto *event = reinterpret_cast<const inotify_event *>(buffer.data() + i);
+        i += sizeof(inotify_event) + event->len;
+
+        // Kernel-side queue overflow; events were lost
+        if (event->mask & IN_Q_OVERFLOW) {
+          for (uint id = 0; id < state->paths.size(); ++id)
+            state->queue.push(id);
+          continue;
+        }
+        
+        // Match file name against the files watched in this directory
+        guard_continue(event->len > 0);
+        auto f = state->dirs.find(event->wd);
+        guard_continue(f != state->dirs.end());
+        std::string_view name = event->name;
+        for (uint id : f->second)
+          if (state->paths[id].filename() == name)
+            state->queue.push(id);
+      }
+    }
+#endif
+  }
+
+  void FileMonitor::run_polling(StateData *state) {
+    while (!state->is_stopped.load()) {
+      std::this_thread::sleep_for(file_monitor_interval);
+
+      std::lock_guard lock(state->mutex);
+      for (uint id = 0; id < state->paths.size(); ++id) {
+        std::error_code ec;
+        auto time = fs::last_write_time(state->paths[id], ec);
+        guard_continue(!ec && time != state->times[id]);
+        state->times[id] = time;
+        state->queue.push(id);
+      }
+    }
+  }
+} // namespace gl::detail
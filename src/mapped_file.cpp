@@ -0,0 +1,79 @@
+#include <small_gl/detail/mapped_file.hpp>
+#include <small_gl/utility.hpp>
+#include <small_gl/detail/trace.hpp>
+#ifdef _WIN32
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+  #endif
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace gl::detail {
+  MappedFile::MappedFile(const fs::path &file_path) {
+    gl_trace();
+    debug::check_expr(fs::exists(file_path),
+      fmt::format("failed to resolve path \"{}\"", file_path.string()));
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    debug::check_expr(file != INVALID_HANDLE_VALUE,
+      fmt::format("failed to open file \"{}\"", file_path.string()));
+    m_file_handle = reinterpret_cast<std::intptr_t>(file);
+
+    LARGE_INTEGER size;
+    GetFileSizeEx(file, &size);
+    m_size = static_cast<size_t>(size.QuadPart);
+    guard(m_size > 0); // Empty files cannot be mapped
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    debug::check_expr(mapping != nullptr,
+      fmt::format("failed to map file \"{}\"", file_path.string()));
+    m_mapping_handle = mapping;
+
+    m_data = static_cast<const std::byte *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    debug::check_expr(m_data != nullptr,
+      fmt::format("failed to map file \"{}\"", file_path.string()));
+#else
+    int fd = open(file_path.c_str(), O_RDONLY);
+    debug::check_expr(fd != -1,
+      fmt::format("failed to open file \"{}\"", file_path.string()));
+    m_file_handle = fd;
+
+    struct stat st;
+    fstat(fd, &st);
+    m_size = static_cast<size_t>(st.st_size);
+    guard(m_size > 0); // Empty files cannot be mapped
+
+    void *data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    debug::check_expr(data != MAP_FAILED,
+      fmt::format("failed to map file \"{}\"", file_path.string()));
+    m_data = static_cast<const std::byte *>(data);
+#endif
+  }
+
+  MappedFile::~MappedFile() {
+    gl_trace();
+#ifdef _WIN32
+    if (m_data)
+      UnmapViewOfFile(m_data);
+    if (m_mapping_handle)
+      CloseHandle(m_mapping_handle);
+    if (m_file_handle != -1)
+      CloseHandle(reinterpret_cast<HANDLE>(m_file_handle));
+#else
+    if (m_data)
+      munmap(const_cast<std::byte *>(m_data), m_size);
+    if (m_file_handle != -1)
+      close(static_cast<int>(m_file_handle));
+#endif
+  }
+} // namespace gl::detail
@@ -0,0 +1,228 @@
+#include <small_gl/mip_generator.hpp>
+#include <small_gl/dispatch.hpp>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cmath>
+#include <string_view>
+
+namespace gl {
+  namespace detail {
+    // Max. nr. of levels written per dispatch; each is bound to a separate image unit
+    constexpr uint mip_generator_max_levels = 4;
+
+    // Compute shader body; variant-specific definitions are prepended by MipGenerator::dispatch.
+    // The first level of a dispatch is reduced from the source image, handling odd sizes by
+    // widening the footprint to three texels; further levels are reduced from shared memory
+    constexpr std::string_view mip_generator_glsl = R"GLSL(
+#if DIMS == 1
+  layout(local_size_x = 64) in;
+#elif DIMS == 2
+  layout(local_size_x = 8, local_size_y = 8) in;
+#else
+  layout(local_size_x = 4, local_size_y = 4, local_size_z = 4) in;
+#endif
+
+#if DIMS == 1
+  #if LAYERED
+    #define COORD(p, l) ivec2(p.x, l)
+  #else
+    #define COORD(p, l) p.x
+  #endif
+#elif DIMS == 2
+  #if LAYERED
+    #define COORD(p, l) ivec3(p.xy, l)
+  #else
+    #define COORD(p, l) p.xy
+  #endif
+#else
+  #define COORD(p, l) p
+#endif
+
+layout(binding = 0, IMAGE_FORMAT) uniform restrict readonly  IMAGE_TYPE b_src;
+layout(binding = 1, IMAGE_FORMAT) uniform restrict writeonly IMAGE_TYPE b_dst_0;
+layout(binding = 2, IMAGE_FORMAT) uniform restrict writeonly IMAGE_TYPE b_dst_1;
+layout(binding = 3, IMAGE_FORMAT) uniform restrict writeonly IMAGE_TYPE b_dst_2;
+layout(binding = 4, IMAGE_FORMAT) uniform restrict writeonly IMAGE_TYPE b_dst_3;
+
+uniform ivec3 u_src_size; // Spatial size of source level, padded with ones
+uniform int   u_levels;   // Nr. of levels written by this dispatch
+
+const ivec3 axes = ivec3(1, DIMS > 1 ? 1 : 0, DIMS > 2 ? 1 : 0);
+
+shared ACC_TYPE s_data[64];
+
+ACC_TYPE reduce(in ACC_TYPE a, in ACC_TYPE b) {
+#if REDUCTION == 1
+  return min(a, b);
+#elif REDUCTION == 2
+  return max(a, b);
+#elif REDUCTION == 3
+  return ACC_TYPE(min(a.x, b.x), max(a.y, b.y), a.zw);
+#else
+  return a + b;
+#endif
+}
+
+void store(in int level, in ivec3 p, in int l, in ACC_TYPE v) {
+#if IS_INTEGER
+  VALUE_TYPE value = VALUE_TYPE(round(v));
+#else
+  VALUE_TYPE value = VALUE_TYPE(v);
+#endif
+  if      (level == 0) imageStore(b_dst_0, COORD(p, l), value);
+  else if (level == 1) imageStore(b_dst_1, COORD(p, l), value);
+  else if (level == 2) imageStore(b_dst_2, COORD(p, l), value);
+  else                 imageStore(b_dst_3, COORD(p, l), value);
+}
+
+void main() {
+  ivec3 p = ivec3(gl_GlobalInvocationID) * axes;
+#if LAYERED
+  int   l = int(gl_GlobalInvocationID[DIMS]);
+#else
+  int   l = 0;
+#endif
+  uint  i = gl_LocalInvocationIndex;
+
+  // First level; reduce a footprint of 2 texels per axis, or 3 at the odd edge, or 1 if unreduced
+  ivec3 dst_size = max(u_src_size / (1 + axes), ivec3(1));
+  ivec3 n_taps   = ivec3(1);
+  for (int a = 0; a < DIMS; ++a) {
+    if (u_src_size[a] > 1)
+      n_taps[a] = (u_src_size[a] % 2 == 1 && p[a] == dst_size[a] - 1) ? 3 : 2;
+  }
+  ivec3 base  = min(p * (1 + axes * ivec3(greaterThan(u_src_size, ivec3(1)))), u_src_size - 1);
+  bool  valid = all(lessThan(p, dst_size));
+
+  ACC_TYPE v = ACC_TYPE(imageLoad(b_src, COORD(min(base, u_src_size - 1), l)));
+  int n = 1;
+  for (int z = 0; z < n_taps.z; ++z)
+  for (int y = 0; y < n_taps.y; ++y)
+  for (int x = 0; x < n_taps.x; ++x) {
+    if (x + y + z == 0)
+      continue;
+    ivec3 q = min(base + ivec3(x, y, z), u_src_size - 1);
+    v = reduce(v, ACC_TYPE(imageLoad(b_src, COORD(q, l))));
+    n++;
+  }
+#if REDUCTION == 0
+  v /= ACC_TYPE(n);
+#endif
+
+  if (valid)
+    store(0, p, l, v);
+  s_data[i] = v;
+
+  // Further levels; footprints are exactly 2 texels per axis, as intermediate sizes are even
+  ivec3 group = ivec3(gl_WorkGroupSize);
+  ivec3 local = ivec3(gl_LocalInvocationID);
+  for (int level = 1; level < u_levels; ++level) {
+    barrier();
+    
+    int  stride    = 1 << level;
+    bool is_active = all(equal(local % stride * axes, ivec3(0)));
+    if (is_active) {
+      int half_stride = stride / 2;
+      ACC_TYPE w = s_data[i];
+      int m = 1;
+      for (int z = 0; z < 1 + axes.z; ++z)
+      for (int y = 0; y < 1 + axes.y; ++y)
+      for (int x = 0; x < 1 + axes.x; ++x) {
+        if (x + y + z == 0)
+          continue;
+        ivec3 o = ivec3(x, y, z) * half_stride;
+        w = reduce(w, s_data[i + o.x + o.y * group.x + o.z * group.x * group.y]);
+        m++;
+      }
+#if REDUCTION == 0
+      w /= ACC_TYPE(m);
+#endif
+      
+      ivec3 q = p >> level;
+      if (valid && all(lessThan(q, max(dst_size >> level, ivec3(1)))))
+        store(level, q, l, w);
+      v = w;
+    }
+
+    barrier();
+    if (is_active)
+      s_data[i] = v;
+  }
+}
+)GLSL";
+  } // namespace detail
+
+  void MipGenerator::dispatch(const DispatchInfo &info) {
+    gl_trace_full();
+
+    // Generate variant prelude, and obtain or compile matching program
+    auto reduction = static_cast<uint>(info.reduction);
+    auto prelude = fmt::format("#version 460 core\n"
+                               "#define DIMS {}\n"
+                               "#define LAYERED {}\n"
+                               "#define IMAGE_TYPE {}\n"
+                               "#define IMAGE_FORMAT {}\n"
+                               "#define VALUE_TYPE {}\n"
+                               "#define ACC_TYPE {}\n"
+                               "#define IS_INTEGER {}\n"
+                               "#define REDUCTION {}\n",
+                               info.dims, info.is_layered ? 1 : 0, info.image_type, info.image_format, 
+                               info.value_type, info.is_integer ? "dvec4" : "vec4", info.is_integer ? 1 : 0, reduction);
+    auto it = m_programs.find(prelude);
+    if (it == m_programs.end()) {
+      auto source = prelude + std::string(detail::mip_generator_glsl);
+      auto bytes  = std::as_bytes(std::span(source));
+      Program program(ShaderLoadStringInfo { .type      = ShaderType::eCompute,
+                                             .glsl_data = std::vector<std::byte>(range_iter(bytes)) });
+      it = m_programs.emplace(prelude, std::move(program)).first;
+    }
+    auto &program = it->second;
+    program.bind();
+
+    // Group sizes match the shader's local size; layers are dispatched along the next axis
+    eig::Array3u group_size = info.dims == 1 ? eig::Array3u(64, 1, 1)
+                            : info.dims == 2 ? eig::Array3u(8, 8, 1)
+                                             : eig::Array3u(4, 4, 4);
+    uint max_batch = std::min(detail::mip_generator_max_levels, 
+                              1 + static_cast<uint>(std::log2(group_size.maxCoeff())));
+
+    // Reduce levels in batches
+    eig::Array3u src_size = (info.size / (1u << info.base_level)).max(1u);
+    for (uint level = info.base_level; level + 1 < info.levels;) {
+      eig::Array3u dst_size = (src_size / 2).max(1u);
+
+      // Extend batch while every reduced axis of the next source level is even and > 1
+      uint batch = 1;
+      for (eig::Array3u next = dst_size; batch < max_batch && level + batch + 1 < info.levels; ++batch) {
+        bool is_even = true;
+        for (uint a = 0; a < info.dims; ++a)
+          is_even &= next[a] > 1 && next[a] % 2 == 0;
+        guard_break(is_even);
+        next = next / 2;
+      }
+      
+      // Bind source and destination levels, layered for arrays and cubemaps
+      glBindImageTexture(0, info.object, level, info.is_layered, 0, GL_READ_ONLY, info.internal_format);
+      for (uint i = 0; i < detail::mip_generator_max_levels; ++i) {
+        uint dst_level = std::min(level + 1 + i, info.levels - 1);
+        glBindImageTexture(1 + i, info.object, dst_level, info.is_layered, 0, GL_WRITE_ONLY, info.internal_format);
+      }
+
+      program.uniform("u_src_size", src_size.cast<int>().eval());
+      program.uniform("u_levels",   static_cast<int>(batch));
+
+      eig::Array3u groups = (dst_size + group_size - 1) / group_size;
+      if (info.is_layered)
+        groups[info.dims] = info.layers;
+      dispatch_compute({ .groups_x = groups.x(), .groups_y = groups.y(), .groups_z = groups.z() });
+      sync::memory_barrier(BarrierFlags::eImageAccess);
+
+      for (uint i = 0; i < batch; ++i)
+        src_size = (src_size / 2).max(1u);
+      level += batch;
+    }
+
+    sync::memory_barrier(BarrierFlags::eTextureFetch);
+    program.unbind();
+  }
+} // namespace gl
@@ -0,0 +1,248 @@
+#include <small_gl/mipmap.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numbers>
+
+namespace gl {
+  namespace detail {
+    // Linear <-> sRGB transfer functions
+    float srgb_to_linear(float v) {
+      return v <= 0.04045f ? v / 12.92f : std::pow((v + 0.055f) / 1.055f, 2.4f);
+    }
+
+    float linear_to_srgb(float v) {
+      return v <= 0.0031308f ? v * 12.92f : 1.055f * std::pow(v, 1.f / 2.4f) - 0.055f;
+    }
+
+    // Zeroth-order modified Bessel function of the first kind, by power series
+    float bessel_i0(float x) {
+      float sum = 1.f, term = 1.f, y = x * x / 4.f;
+      for (uint k = 1; k < 32; ++k) {
+        term *= y / static_cast<float>(k * k);
+        sum  += term;
+        guard_break(term > 1e-8f * sum);
+      }
+      return sum;
+    }
+
+    // Kaiser window over [-1, 1]
+    float kaiser(float x, float alpha) {
+      guard(std::abs(x) < 1.f, 0.f);
+      float a = std::numbers::pi_v<float> * alpha;
+      return bessel_i0(a * std::sqrt(1.f - x * x)) / bessel_i0(a);
+    }
+
+    // Normalized sinc
+    float sinc(float x) {
+      guard(std::abs(x) > 1e-6f, 1.f);
+      float px = std::numbers::pi_v<float> * x;
+      return std::sin(px) / px;
+    }
+
+    // Separable filter taps for a single axis; each destination texel reads width source texels
+    struct MipTapData {
+      uint               width = 1;
+      std::vector<uint>  indices; // Source texel per tap, clamped to edge
+      std::vector<float> weights; // Normalized weight per tap
+    };
+
+    MipTapData mip_taps(uint n_src, uint n_dst, const MipChainInfo &info) {
+      gl_trace();
+
+      // Axis is not reduced; identity taps
+      if (n_src == n_dst) {
+        MipTapData taps = { .width = 1, .indices = std::vector<uint>(n_dst), .weights = std::vector<float>(n_dst, 1.f) };
+        for (uint i = 0; i < n_dst; ++i)
+          taps.indices[i] = i;
+        return taps;
+      }
+
+      float scale  = static_cast<float>(n_src) / static_cast<float>(n_dst);
+      float radius = info.filter == MipFilter::eBox ? .5f * scale : info.kaiser_width * scale;
+      
+      MipTapData taps;
+      taps.width = static_cast<uint>(std::ceil(2.f * radius)) + 1;
+      taps.indices.resize(n_dst * taps.width, 0);
+      taps.weights.resize(n_dst * taps.width, 0.f);
+
+      for (uint i = 0; i < n_dst; ++i) {
+        float center = (static_cast<float>(i) + .5f) * scale;
+        int   first  = static_cast<int>(std::floor(center - radius));
+        float sum    = 0.f;
+
+        for (uint t = 0; t < taps.width; ++t) {
+          int   j = first + static_cast<int>(t);
+          float x = (static_cast<float>(j) + .5f - center) / scale; // Distance in destination texels
+          
+          float w;
+          if (info.filter == MipFilter::eBox) {
+            // Overlap of source texel with destination texel footprint
+            float lo = std::max(static_cast<float>(j),      center - radius);
+            float hi = std::min(static_cast<float>(j + 1), center + radius);
+            w = std::max(hi - lo, 0.f);
+          } else {
+            w = sinc(x) * kaiser(x / info.kaiser_width, info.kaiser_alpha);
+          }
+
+          taps.indices[i * taps.width + t] = static_cast<uint>(std::clamp(j, 0, static_cast<int>(n_src) - 1));
+          taps.weights[i * taps.width + t] = w;
+          sum += w;
+        }
+
+        for (uint t = 0; t < taps.width; ++t)
+          taps.weights[i * taps.width + t] /= sum;
+      }
+
+      return taps;
+    }
+
+    // Filter a buffer of pixels along one axis, from src_size to dst_size; other axes are unchanged
+    template <uint C>
+    void mip_filter_axis(const std::vector<eig::Array<float, C, 1>> &src,
+                               std::vector<eig::Array<float, C, 1>> &dst,
+                         const eig::Array3u                         &src_size,
+                         const eig::Array3u                         &dst_size,
+                         uint                                        axis,
+                         const MipTapData                           &taps) {
+      gl_trace();
+      using pixel = eig::Array<float, C, 1>;
+
+      dst.resize(dst_size.prod());
+      eig::Array3u src_stride = { 1, src_size.x(), src_size.x() * src_size.y() };
+      eig::Array3u dst_stride = { 1, dst_size.x(), dst_size.x() * dst_size.y() };
+
+      // Parallelize over rows of the destination
+      int n_rows = static_cast<int>(dst_size.y() * dst_size.z());
+      #pragma omp parallel for
+      for (int row = 0; row < n_rows; ++row) {
+        uint y = static_cast<uint>(row) % dst_size.y(), z = static_cast<uint>(row) / dst_size.y();
+        for (uint x = 0; x < dst_size.x(); ++x) {
+          eig::Array3u xyz = { x, y, z };
+          uint i = xyz[axis];
+
+          // Source offset of texel with the filtered axis zeroed
+          eig::Array3u base = xyz;
+          base[axis] = 0;
+          size_t src_base = (base * src_stride).sum();
+
+          pixel sum = pixel::Zero();
+          for (uint t = 0; t < taps.width; ++t)
+            sum += taps.weights[i * taps.width + t] 
+                 * src[src_base + static_cast<size_t>(taps.indices[i * taps.width + t]) * src_stride[axis]];
+          dst[(xyz * dst_stride).sum()] = sum;
+        }
+      }
+    }
+  } // namespace detail
+
+  template <typename T, uint D, uint C>
+  std::vector<T> generate_mip_chain(std::span<const T> data, eig::Array<uint, D, 1> size, MipChainInfo info) {
+    gl_trace();
+    using pixel = eig::Array<float, C, 1>;
+
+    debug::check_expr(data.size() >= static_cast<size_t>(size.prod()) * C,
+      "generate_mip_chain(...) provided data span is too small for requested size");
+    debug::check_expr(!info.is_alpha_weighted || C == 4,
+      "generate_mip_chain(...) alpha weighting requires four-component data");
+
+    // Determine nr. of levels; the full chain ends at a single texel
+    uint max_levels = 1 + static_cast<uint>(std::floor(std::log2(static_cast<float>(size.maxCoeff()))));
+    uint levels     = info.levels == 0 ? max_levels : std::min(info.levels, max_levels);
+
+    // Integer values are normalized if their meaning depends on range
+    constexpr bool is_integral = std::is_integral_v<T>;
+    const bool     is_norm     = is_integral && (info.is_srgb || info.is_alpha_weighted);
+    const float    norm_scale  = is_norm ? static_cast<float>(std::numeric_limits<T>::max()) : 1.f;
+    constexpr uint n_color     = C == 4 ? 3 : C; // Components subject to sRGB/alpha weighting
+
+    // Pad size to three dimensions
+    eig::Array3u size_3 = eig::Array3u::Ones();
+    size_3.head<D>() = size;
+
+    // Decode base level into linear, (alpha-weighted) floating point pixels
+    std::vector<pixel> src(size_3.prod()), dst;
+    #pragma omp parallel for
+    for (int i = 0; i < static_cast<int>(src.size()); ++i) {
+      pixel p;
+      for (uint c = 0; c < C; ++c)
+        p[c] = static_cast<float>(data[i * C + c]) / norm_scale;
+      if (info.is_srgb)
+        for (uint c = 0; c < n_color; ++c)
+          p[c] = detail::srgb_to_linear(std::clamp(p[c], 0.f, 1.f));
+      if constexpr (C == 4)
+        if (info.is_alpha_weighted)
+          p.template head<3>() *= std::clamp(p[3], 0.f, 1.f);
+      src[i] = p;
+    }
+
+    // Base level is copied verbatim
+    std::vector<T> chain(data.begin(), data.begin() + size_3.prod() * C);
+
+    for (uint level = 1; level < levels; ++level) {
+      eig::Array3u next_3 = (size_3 / 2).max(1u);
+
+      // Separable passes along each reduced axis
+      for (uint axis = 0; axis < D; ++axis) {
+        guard_continue(next_3[axis] != size_3[axis]);
+        auto taps = detail::mip_taps(size_3[axis], next_3[axis], info);
+        eig::Array3u pass_size = size_3;
+        pass_size[axis] = next_3[axis];
+        detail::mip_filter_axis<C>(src, dst, size_3, pass_size, axis, taps);
+        std::swap(src, dst);
+        size_3 = pass_size;
+      }
+
+      // Encode level; filtering continues from the unencoded floating point pixels
+      size_t chain_offset = chain.size();
+      chain.resize(chain_offset + src.size() * C);
+      #pragma omp parallel for
+      for (int i = 0; i < static_cast<int>(src.size()); ++i) {
+        pixel p = src[i];
+        if constexpr (C == 4)
+          if (info.is_alpha_weighted) {
+            float alpha = std::clamp(p[3], 0.f, 1.f);
+            p.template head<3>() = alpha > 0.f ? (p.template head<3>() / alpha).eval() : pixel::Zero().template head<3>().eval();
+          }
+        if (info.is_srgb)
+          for (uint c = 0; c < n_color; ++c)
+            p[c] = detail::linear_to_srgb(std::clamp(p[c], 0.f, 1.f));
+        for (uint c = 0; c < C; ++c) {
+          if constexpr (is_integral) {
+            float v = std::round(p[c] * norm_scale);
+            v = std::clamp(v, static_cast<float>(std::numeric_limits<T>::lowest()), 
+                              static_cast<float>(std::numeric_limits<T>::max()));
+            chain[chain_offset + i * C + c] = static_cast<T>(v);
+          } else {
+            chain[chain_offset + i * C + c] = static_cast<T>(p[c]);
+          }
+        }
+      }
+    }
+
+    return chain;
+  }
+
+  /* Explicit template instantiations of gl::generate_mip_chain<...> */
+
+  #define gl_explicit_mip_chain(type, dims, components)                                    \
+    template std::vector<type> generate_mip_chain<type, dims, components>(                 \
+      std::span<const type>, eig::Array<uint, dims, 1>, MipChainInfo);
+
+  #define gl_explicit_mip_chain_components_1234(type, dims)\
+    gl_explicit_mip_chain(type, dims, 1)\
+    gl_explicit_mip_chain(type, dims, 2)\
+    gl_explicit_mip_chain(type, dims, 3)\
+    gl_explicit_mip_chain(type, dims, 4)
+
+  #define gl_explicit_mip_chain_dims_123(type)\
+    gl_explicit_mip_chain_components_1234(type, 1)\
+    gl_explicit_mip_chain_components_1234(type, 2)\
+    gl_explicit_mip_chain_components_1234(type, 3)
+  gl_explicit_mip_chain_dims_123(ushort)
+  gl_explicit_mip_chain_dims_123(short)
+  gl_explicit_mip_chain_dims_123(uint)
+  gl_explicit_mip_chain_dims_123(int)
+  gl_explicit_mip_chain_dims_123(float)
+} // namespace gl
@@ -0,0 +1,143 @@
+#include <small_gl/permutation.hpp>
+#include <small_gl/utility.hpp>
+#include <small_gl/detail/trace.hpp>
+#include <glad/glad.h>
+#include <algorithm>
+#include <array>
+#include <span>
+
+namespace gl {
+  namespace rng = std::ranges;
+
+  uint64_t PermutationKey::hash() const {
+    // Entries are hashed individually and summed, so hashes are independent of the order of 
+    // constants and definitions
+    uint64_t hash = 0;
+    for (const auto &[i, value] : spec_const) {
+      std::array<uint, 2> data = { i, value };
+      hash += io::hash_bytes(std::as_bytes(std::span(data)));
+    }
+    for (const auto &[name, value] : defines)
+      hash += io::hash_bytes(std::as_bytes(std::span(value)), io::hash_bytes(std::as_bytes(std::span(name)), 1));
+    return hash;
+  }
+
+  bool PermutationKey::operator==(const PermutationKey &o) const {
+    // Test inclusion both ways, as either may hold entries in any order
+    auto is_subset = [](const auto &a, const auto &b) {
+      return rng::all_of(a, [&](const auto &v) { return rng::find(b, v) != b.end(); });
+    };
+    return spec_const.size() == o.spec_const.size() && defines.size() == o.defines.size()
+        && is_subset(spec_const, o.spec_const) && is_subset(o.spec_const, spec_const)
+        && is_subset(defines, o.defines)       && is_subset(o.defines, defines);
+  }
+
+  PermutationCache::PermutationCache(PermutationCacheInfo info)
+  : m_info(std::move(info)) {
+    gl_trace();
+    debug::check_expr(!m_info.info.empty(), "PermutationCache requires a base shader");
+
+    // Generic variant is compiled up front, as it serves as fallback for pending variants
+    m_generic = Program(m_info.info);
+  }
+
+  bool PermutationCache::contains(const PermutationKey &key) const {
+    gl_trace();
+    return m_variants.contains(key);
+  }
+
+  Program &PermutationCache::at(const PermutationKey &key) {
+    gl_trace();
+    debug::check_expr(is_init(), "attempt to use an uninitialized object");
+    guard(!key.spec_const.empty() || !key.defines.empty(), m_generic);
+
+    auto f = m_variants.find(key);
+    if (f == m_variants.end()) {
+      // Derive variant info from base shader; constants and definitions override base constants
+      // of the same index and base definitions of the same name
+      auto info = m_info.info;
+      for (auto &stage : info) {
+        for (const auto &[i, value] : key.spec_const) {
+          auto it = rng::find(stage.spec_const, i, &std::pair<uint, uint>::first);
+          if (it != stage.spec_const.end())
+            it->second = value;
+          else
+            stage.spec_const.push_back({ i, value });
+        }
+        for (const auto &[name, value] : key.defines) {
+          auto it = rng::find(stage.defines, name, &std::pair<std::string, std::string>::first);
+          if (it != stage.defines.end())
+            it->second = value;
+          else
+            stage.defines.push_back({ name, value });
+        }
+      }
+
+      // Build the program first, so a failed compile leaves the cache untouched; then insert
+      // as most recently used, and evict others if over program count budget
+      VariantData data = { .program = m_info.is_async ? Program::make_async(info) : Program(info) };
+      f = m_variants.emplace(key, std::move(data)).first;
+      m_lru.push_front(&f->first);
+      f->second.lru_it = m_lru.begin();
+      if (m_info.is_async)
+        evict();
+      else
+        commit(f->second);
+    } else {
+      // Move to front of LRU list; list iterators remain valid
+      m_lru.splice(m_lru.begin(), m_lru, f->second.lru_it);
+    }
+
+    // Fall back to generic variant while compilation is in flight, or if it failed
+    auto &data = f->second;
+    guard(!data.is_failed, m_generic);
+    if (data.program.is_pending()) {
+      guard(data.program.is_ready(), m_generic);
+      
+      // On failure, release the variant's program but keep its entry, so it is not resubmitted
+      try {
+        data.program.resolve();
+      } catch (...) {
+        data.program   = { };
+        data.is_failed = true;
+        throw;
+      }
+      commit(data);
+    }
+
+    return data.program;
+  }
+
+  void PermutationCache::commit(VariantData &data) {
+    gl_trace();
+    GLint length;
+    glGetProgramiv(data.program.object(), GL_PROGRAM_BINARY_LENGTH, &length);
+    data.binary_size = static_cast<size_t>(length);
+    m_binary_size   += data.binary_size;
+    evict();
+  }
+
+  void PermutationCache::evict() {
+    gl_trace();
+
+    auto is_over_budget = [&]() {
+      return (m_info.max_programs    > 0 && m_variants.size() > m_info.max_programs) 
+          || (m_info.max_binary_size > 0 && m_binary_size     > m_info.max_binary_size);
+    };
+
+    // Evict least-recently-used variants; the most recently used variant always remains
+    while (m_lru.size() > 1 && is_over_budget()) {
+      auto f = m_variants.find(*m_lru.back());
+      m_binary_size -= f->second.binary_size;
+      m_variants.erase(f);
+      m_lru.pop_back();
+    }
+  }
+
+  void PermutationCache::clear() {
+    gl_trace();
+    m_variants.clear();
+    m_lru.clear();
+    m_binary_size = 0;
+  }
+} // namespace gl
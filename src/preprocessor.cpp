@@ -0,0 +1,308 @@
+#include <small_gl/detail/preprocessor.hpp>
+#include <small_gl/utility.hpp>
+#include <small_gl/detail/trace.hpp>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+// stb_c_lexer configuration; identical to the library defaults, except that preprocessor
+// lines are kept, and GLSL's integer/float literal suffixes are parsed
+#define STB_C_LEX_C_DECIMAL_INTS    Y
+#define STB_C_LEX_C_HEX_INTS        Y
+#define STB_C_LEX_C_OCTAL_INTS      Y
+#define STB_C_LEX_C_DECIMAL_FLOATS  Y
+#define STB_C_LEX_C99_HEX_FLOATS    N
+#define STB_C_LEX_C_IDENTIFIERS     Y
+#define STB_C_LEX_C_DQ_STRINGS      Y
+#define STB_C_LEX_C_SQ_STRINGS      N
+#define STB_C_LEX_C_CHARS           Y
+#define STB_C_LEX_C_COMMENTS        Y
+#define STB_C_LEX_CPP_COMMENTS      Y
+#define STB_C_LEX_C_COMPARISONS     Y
+#define STB_C_LEX_C_LOGICAL         Y
+#define STB_C_LEX_C_SHIFTS          Y
+#define STB_C_LEX_C_INCREMENTS      Y
+#define STB_C_LEX_C_ARROW           Y
+#define STB_C_LEX_EQUAL_ARROW       N
+#define STB_C_LEX_C_BITWISEEQ       Y
+#define STB_C_LEX_C_ARITHEQ         Y
+#define STB_C_LEX_PARSE_SUFFIXES    Y
+#define STB_C_LEX_DECIMAL_SUFFIXES  "uU"
+#define STB_C_LEX_HEX_SUFFIXES      "uU"
+#define STB_C_LEX_OCTAL_SUFFIXES    "uU"
+#define STB_C_LEX_FLOAT_SUFFIXES    "fFlL"
+#define STB_C_LEX_0_IS_EOF             N
+#define STB_C_LEX_INTEGERS_AS_DOUBLES  N
+#define STB_C_LEX_MULTILINE_DSTRINGS   N
+#define STB_C_LEX_MULTILINE_SSTRINGS   N
+#define STB_C_LEX_USE_STDLIB           Y
+#define STB_C_LEX_DOLLAR_IDENTIFIER    N
+#define STB_C_LEX_FLOAT_NO_DECIMAL     Y
+#define STB_C_LEX_DEFINE_ALL_TOKEN_NAMES  N
+#define STB_C_LEX_DISCARD_PREPROCESSOR    N
+#define STB_C_LEXER_DEFINITIONS
+#define STB_C_LEXER_IMPLEMENTATION
+#include <stb_c_lexer.h>
+#undef Y
+#undef N
+
+namespace gl::detail {
+  namespace {
+    // Size of lexer storage for identifiers and string literals
+    constexpr size_t glsl_lexer_store_size = 4096;
+
+    // Cached preprocessor output, with content hashes of included files for validation
+    struct GLSLCacheData {
+      fs::path                                   source_path;
+      uint64_t                                   source_hash;
+      std::string                                source;
+      std::vector<std::pair<fs::path, uint64_t>> includes;
+    };
+
+    // Preprocessor output cache; shaders may be compiled on worker threads, so access is locked.
+    // Entries of an edited source file are evicted when its new output is stored
+    std::mutex                                  glsl_cache_mutex;
+    std::unordered_map<uint64_t, GLSLCacheData> glsl_cache;
+
+    uint64_t hash_string(std::string_view s, uint64_t seed) {
+      return io::hash_bytes(std::as_bytes(std::span(s)), seed);
+    }
+
+    // Format a specialization constant value for its declared type; as with glSpecializeShader,
+    // values are specified as raw 32-bit data
+    std::string format_spec_const(std::string_view type, uint value) {
+      if (type == "bool")
+        return value ? "true" : "false";
+      else if (type == "int")
+        return fmt::format("{}", std::bit_cast<int>(value));
+      else if (type == "float")
+        return fmt::format("{:.9g}", std::bit_cast<float>(value));
+      else
+        return fmt::format("{}u", value);
+    }
+
+    class GLSLPreprocessor {
+      const GLSLPreprocessInfo &m_info;
+      std::vector<fs::path>     m_stack;    // Files currently being processed, to detect recursion
+      std::vector<fs::path>     m_includes; // All included files
+      std::vector<uint64_t>     m_hashes;   // Content hashes of included files, as read
+
+      fs::path resolve_include(std::string_view name, bool is_quoted, const fs::path &parent_path) const {
+        gl_trace();
+
+        // Quoted includes are first resolved relative to the including file
+        std::vector<fs::path> candidates;
+        if (is_quoted && !parent_path.empty())
+          candidates.push_back(parent_path.parent_path() / name);
+        for (const auto &dir : m_info.include_dirs)
+          candidates.push_back(dir / name);
+        if (!is_quoted && !parent_path.empty())
+          candidates.push_back(parent_path.parent_path() / name);
+
+        for (const auto &path : candidates)
+          if (fs::exists(path))
+            return fs::canonical(path);
+
+        debug::check_expr(false,
+          fmt::format("GLSL preprocessor failed to resolve include \"{}\" in \"{}\"", name, parent_path.string()));
+        return { };
+      }
+
+    public:
+      GLSLPreprocessor(const GLSLPreprocessInfo &info)
+      : m_info(info) { 
+        if (!info.source_path.empty() && fs::exists(info.source_path))
+          m_stack.push_back(fs::canonical(info.source_path));
+      }
+
+      std::string process(std::string_view source, const fs::path &path, bool is_root) {
+        gl_trace();
+
+        const char *begin = source.data(),
+                   *end   = source.data() + source.size();
+
+        // Output is copied from source lazily, up until the next replaced range
+        std::string out;
+        out.reserve(source.size());
+        const char *copied = begin;
+        auto emit_until = [&](const char *p) { out.append(copied, p); copied = p; };
+        auto skip_until = [&](const char *p) { copied = p; };
+
+        // Helpers to find line boundaries and numbers
+        auto line_end   = [&](const char *p) { return std::find(p, end, '\n'); };
+        auto line_of    = [&](const char *p) { return 1 + std::count(begin, p, '\n'); };
+        auto line_start = [&](const char *p) {
+          auto it = p;
+          while (it != begin && (*(it - 1) == ' ' || *(it - 1) == '\t'))
+            --it;
+          return it == begin || *(it - 1) == '\n';
+        };
+
+        std::array<char, glsl_lexer_store_size> store;
+        stb_lexer lex;
+        stb_c_lexer_init(&lex, begin, end, store.data(), store.size());
+        auto next    = [&]() { return stb_c_lexer_get_token(&lex) != 0; };
+        auto is_id   = [&](std::string_view s) { return lex.token == CLEX_id && std::string_view(lex.string) == s; };
+
+        while (next()) {
+          if (lex.token == '#' && line_start(lex.where_firstchar)) {
+            const char *directive = lex.where_firstchar;
+            const char *eol       = line_end(lex.parse_point);
+            guard_continue(next());
+
+            if (is_id("version")) {
+              // Inject definitions directly after #version, then restore line numbering
+              if (is_root && !m_info.defines.empty()) {
+                emit_until(eol);
+                for (const auto &[name, value] : m_info.defines)
+                  out += fmt::format("\n#define {} {}", name, value);
+                out += fmt::format("\n#line {}", line_of(directive) + 1);
+              }
+            } else if (is_id("extension")) {
+              // Strip include extensions required by glslang, as includes are resolved here
+              auto rest = std::string_view(lex.parse_point, eol);
+              if (rest.contains("GL_GOOGLE_include_directive") || rest.contains("GL_ARB_shading_language_include")) {
+                emit_until(directive);
+                skip_until(eol);
+              }
+            } else if (is_id("include")) {
+              // Parse "name" or <name> from remainder of line
+              auto rest  = std::string_view(lex.parse_point, eol);
+              auto open  = rest.find_first_of("\"<");
+              debug::check_expr(open != std::string_view::npos,
+                fmt::format("GLSL preprocessor encountered malformed #include in \"{}\"", path.string()));
+              bool is_quoted = rest[open] == '"';
+              auto close = rest.find(is_quoted ? '"' : '>', open + 1);
+              debug::check_expr(close != std::string_view::npos,
+                fmt::format("GLSL preprocessor encountered malformed #include in \"{}\"", path.string()));
+
+              // Resolve and recursively process included file
+              auto include_path = resolve_include(rest.substr(open + 1, close - open - 1), is_quoted, path);
+              debug::check_expr(std::ranges::find(m_stack, include_path) == m_stack.end(),
+                fmt::format("GLSL preprocessor encountered recursive #include of \"{}\"", include_path.string()));
+              auto include_data = io::load_string(include_path);
+              m_includes.push_back(include_path);
+              m_hashes.push_back(hash_string(include_data, 0));
+              m_stack.push_back(include_path);
+              auto include_source = process(include_data, include_path, false);
+              m_stack.pop_back();
+
+              // Replace directive with included source, and restore line numbering
+              emit_until(directive);
+              out += fmt::format("#line 1\n{}\n#line {}", include_source, line_of(directive) + 1);
+              skip_until(eol);
+            }
+
+            // Remaining directives are left to the driver; skip to end of line
+            lex.parse_point = const_cast<char *>(eol);
+          } else if (is_id("layout")) {
+            // Parse layout qualifier, and test for a constant_id
+            const char *layout_begin = lex.where_firstchar;
+            guard_continue(next() && lex.token == '(');
+            std::optional<uint> const_id;
+            for (int depth = 1; depth > 0 && next(); ) {
+              if (lex.token == '(') {
+                depth++;
+              } else if (lex.token == ')') {
+                depth--;
+              } else if (is_id("constant_id") && next() && lex.token == '=' && next() && lex.token == CLEX_intlit) {
+                const_id = static_cast<uint>(lex.int_number);
+              }
+            }
+            guard_continue(const_id.has_value());
+
+            // Strip qualifier and trailing whitespace, as constant_id is a SPIR-V only qualifier
+            const char *layout_end = lex.parse_point;
+            while (layout_end != end && (*layout_end == ' ' || *layout_end == '\t'))
+              ++layout_end;
+            emit_until(layout_begin);
+            skip_until(layout_end);
+
+            // Parse declaration up to initializer; expected form is '[const] type name = value;'
+            std::vector<std::string> ids;
+            while (next() && lex.token != '=' && lex.token != ';')
+              if (lex.token == CLEX_id)
+                ids.push_back(lex.string);
+            guard_continue(lex.token == '=' && ids.size() >= 2);
+            const char *init_begin = lex.parse_point;
+            while (next() && lex.token != ';')
+              ;
+            guard_continue(lex.token == ';');
+            const char *init_end = lex.where_firstchar;
+
+            // Replace initializer if a value is specified; otherwise the default value remains
+            auto it = std::ranges::find(m_info.spec_const, *const_id, &std::pair<uint, uint>::first);
+            guard_continue(it != m_info.spec_const.end());
+            emit_until(init_begin);
+            out += " " + format_spec_const(ids[ids.size() - 2], it->second);
+            skip_until(init_end);
+          }
+        }
+
+        emit_until(end);
+        return out;
+      }
+
+      std::vector<fs::path> &includes() { return m_includes; }
+      std::vector<uint64_t> &hashes()   { return m_hashes;   }
+    };
+  } // namespace
+
+  GLSLPreprocessData preprocess_glsl(const GLSLPreprocessInfo &info) {
+    gl_trace_full();
+
+    // Generate cache key from source and all inputs
+    uint64_t source_hash = hash_string(info.source, 0);
+    uint64_t key = hash_string(info.source_path.string(), source_hash);
+    for (const auto &dir : info.include_dirs)
+      key = hash_string(dir.string(), key);
+    for (const auto &[i, value] : info.spec_const) {
+      key = io::hash_bytes(std::as_bytes(std::span(&i, 1)), key);
+      key = io::hash_bytes(std::as_bytes(std::span(&value, 1)), key);
+    }
+    for (const auto &[name, value] : info.defines) {
+      key = hash_string(name, key);
+      key = hash_string(value, key);
+    }
+
+    // Return cached output if included files are unchanged
+    std::optional<GLSLCacheData> cached;
+    {
+      std::lock_guard lock(glsl_cache_mutex);
+      if (auto f = glsl_cache.find(key); f != glsl_cache.end())
+        cached = f->second;
+    }
+    if (cached && std::ranges::all_of(cached->includes, [](const auto &pair) {
+      return fs::exists(pair.first) && io::hash_file(pair.first) == pair.second;
+    })) {
+      GLSLPreprocessData data = { .source = std::move(cached->source) };
+      for (auto &[path, hash] : cached->includes)
+        data.includes.push_back(std::move(path));
+      return data;
+    }
+
+    // Preprocess source
+    GLSLPreprocessor preprocessor(info);
+    auto source   = preprocessor.process(info.source, info.source_path, true);
+    auto includes = std::move(preprocessor.includes());
+
+    // Store output in cache, alongside content hashes of included files as they were read; 
+    // entries of older contents of the same source file are evicted, as it was edited
+    GLSLCacheData data = { .source_path = info.source_path, .source_hash = source_hash, .source = source };
+    for (uint i = 0; i < includes.size(); ++i)
+      data.includes.push_back({ includes[i], preprocessor.hashes()[i] });
+    {
+      std::lock_guard lock(glsl_cache_mutex);
+      if (!info.source_path.empty())
+        std::erase_if(glsl_cache, [&](const auto &pair) {
+          return pair.second.source_path == info.source_path && pair.second.source_hash != source_hash;
+        });
+      glsl_cache.insert_or_assign(key, std::move(data));
+    }
+
+    return { .source = std::move(source), .includes = std::move(includes) };
+  }
+} // namespace gl::detail
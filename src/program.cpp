@@ -4,12 +4,19 @@
 #include <small_gl/texture.hpp>
 #include <small_gl/utility.hpp>
 #include <small_gl/detail/eigen.hpp>
+#include <small_gl/detail/preprocessor.hpp>
 #include <nlohmann/json.hpp>
-#include <zstr.hpp>
+#include <zlib.h>
+#include <zstd.h>
 #include <algorithm>
-#include <execution>
+#include <chrono>
+#include <exception>
 #include <functional>
+#include <mutex>
 #include <ranges>
+#include <cstring>
+#include <fstream>
+#include <spanstream>
 #include <sstream>
 
 namespace gl {
@@ -37,8 +44,8 @@ namespace gl {
 
   namespace io {
     // Serialization for std::unordered_map<std::string,...>
-    template <typename Ty> /* requires(!is_serializable<Ty>) */
-    void to_stream(const std::unordered_map<std::string, Ty> &v, std::ostream &str) {
+    template <typename Ty, typename Hash, typename Eq> /* requires(!is_serializable<Ty>) */
+    void to_stream(const std::unordered_map<std::string, Ty, Hash, Eq> &v, std::ostream &str) {
       gl_trace();
       
       to_stream(v.size(), str);
@@ -49,8 +56,8 @@ namespace gl {
     }
 
     // Serialization for std::unordered_map<std::string,...>
-    template <typename Ty> /* requires (!is_serializable<Ty>) */
-    void from_stream(std::unordered_map<std::string, Ty> &v, std::istream &str) {
+    template <typename Ty, typename Hash, typename Eq> /* requires (!is_serializable<Ty>) */
+    void from_stream(std::unordered_map<std::string, Ty, Hash, Eq> &v, std::istream &str) {
       gl_trace();
 
       size_t n;
@@ -90,9 +97,64 @@ namespace gl {
                       cross_path.string());
     for (const auto &[i, value] : spec_const)
       ss << fmt::format("_({},{})", i, value);
+    for (const auto &[name, value] : defines)
+      ss << fmt::format("_({}={})", name, value);
+    for (const auto &dir : include_dirs)
+      ss << fmt::format("_[{}]", dir.string());
     return ss.str();
   }
 
+  std::string program_key_from_info(std::span<const ShaderLoadFileInfo> info) {
+    // Generate key from join of consecutive info object keys
+    auto in = info | vws::transform([](const auto &i) { return i.to_string(); }) | vws::join;
+    std::string key;
+    rng::copy(in, std::back_inserter(key));
+    return key;
+  }
+
+  namespace detail {
+    // Preprocess glsl source for the non-spirv path; resolves includes, definitions, and spec constants
+    std::vector<std::byte> preprocess_glsl_data(std::span<const std::byte> data, const fs::path &path, 
+                                                const auto &info) {
+      gl_trace();
+      auto source = cast_span<const char>(data);
+      auto output = preprocess_glsl({ .source       = std::string_view(source.data(), source.size()),
+                                      .source_path  = path,
+                                      .include_dirs = info.include_dirs,
+                                      .spec_const   = info.spec_const,
+                                      .defines      = info.defines }).source;
+      auto bytes  = std::as_bytes(std::span(output));
+      return { range_iter(bytes) };
+    }
+  } // namespace detail
+
+  uint64_t program_hash_from_info(std::span<const ShaderLoadFileInfo> info) {
+    gl_trace();
+
+    // Seed with driver identity, as program binaries are only valid on the driver that produced them
+    auto driver_id = get_driver_id();
+    uint64_t hash  = io::hash_bytes(std::as_bytes(std::span(driver_id)));
+
+    // Chain hashes of contents of files that would be loaded, alongside spec constants
+    for (const auto &i : info) {
+      hash = io::hash_bytes(std::as_bytes(std::span(&i.type, 1)), hash);
+      if (!i.spirv_path.empty() && get_vendor() != VendorType::eIntel)
+        hash = io::hash_file(i.spirv_path, hash);
+      else if (!i.glsl_path.empty()) // Preprocessed source covers includes and definitions
+        hash = io::hash_bytes(detail::preprocess_glsl_data(io::load_binary(i.glsl_path), i.glsl_path, i), hash);
+      if (!i.cross_path.empty())
+        hash = io::hash_file(i.cross_path, hash);
+      hash = io::hash_bytes(std::as_bytes(std::span(i.spec_const)), hash);
+    }
+
+    return hash;
+  }
+
+  std::string program_hash_key(uint64_t hash) {
+    // Cache file entries are keyed by content hash, so they are independent of file paths
+    return fmt::format("{:016x}", hash);
+  }
+
   std::string program_name_from_paths(std::span<const ShaderLoadFileInfo> info) {
     // Gather filenames of relevant shader files or spirv binaries
     auto names 
@@ -169,7 +231,7 @@ namespace gl {
       throw e;
     }
 
-    GLuint attach_shader_object(GLuint program, const ShaderCreateInfo &info) {
+    GLuint submit_shader_object(GLuint program, const ShaderCreateInfo &info) {
       gl_trace_full();
 
       // Assemble shader object
@@ -187,77 +249,16 @@ namespace gl {
         glShaderBinary(1, &object, GL_SHADER_BINARY_FORMAT_SPIR_V, ptr, size);
         glSpecializeShader(object, "main", info.spirv_spec_const.size(), const_i.data(), const_v.data());
       } else {
-        // As the glsl path does not support specialization constants, we replace these manually
-        std::string copy(range_iter(detail::cast_span<const char>(std::span(info.data))));
-
-        // Split into vector of lines
-        std::vector<std::string> lines;
-        auto split_view = vws::split('\n') | vws::transform([](const auto &l) { return std::string(range_iter(l)); });
-        rng::copy(copy | split_view, std::back_inserter(lines));
-
-        // Find lines of interest and override them to a specified value;
-        // expected format of line is approximately 'layout(constant_id = 2) const uint bla = 1;'
-        // TODO clean this up after presentation, no time no time
-        std::for_each(std::execution::par_unseq, range_iter(lines), [&](std::string &line) {
-          guard(line.contains("constant_id"));
-          
-          // Strip '\r'
-          line.erase(std::remove_if(range_iter(line), [](char c) { return c == '\r'; }), line.end());
-
-          // Find substring beyond '=' and before ')', then strip ' ' from what remians
-          auto subitr = line.find_first_of('=');
-          auto substr = line.substr(subitr + 1);
-          
-          // On ')', we know the constant id is the previous part
-          subitr = substr.find_first_of(')');
-          auto substr_before = substr.substr(0, subitr);
-          auto substr_after  = substr.substr(subitr + 1);
-
-          // Strip whitespace from previous part, what remains is constant id
-          substr.erase(std::remove_if(range_iter(substr), [](char c) { return c == ' '; }), substr.end());
-
-          // Split on whitespace in after part, get iterator over line data
-          std::vector<std::string> line_split;
-          auto split_view = vws::split(' ') | vws::transform([](const auto &l) { return std::string(range_iter(l)); });
-          rng::copy_if(substr_after | split_view, std::back_inserter(line_split), [](auto c) { return !c.empty(); });
-          auto line_itr = line_split.begin();
-
-          // Extract variable type, variable name, variable value;
-          // expected format is 'const type name = value', though const is optional
-          if (*line_itr == "const") 
-            line_itr++;
-          std::string type_name = *line_itr;
-          line_itr++;
-          std::string varl_name = *line_itr;
-          line_itr++;
-          line_itr++;
-          std::string varl_value = *line_itr;
-
-          // Find new spec const value and replace line entirely if specified
-          auto it = rng::find(info.spirv_spec_const, 
-                              static_cast<uint>(std::stoi(substr)), 
-                              [](const auto &pair) { return pair.first; });
-          if (it != info.spirv_spec_const.end())
-            varl_value = fmt::format("{}", it->second);
-          
-          // Finally, replace line
-          line = fmt::format("const {} {} = {};", type_name, varl_name, varl_value);
-        });
-
-        // Merge back into string
-        copy.clear();
-        rng::copy(lines | vws::join_with('\n'), std::back_inserter(copy));
-
-        // Get raw ptr/size in requested types
-        auto *ptr = (GLchar *) copy.data();
-        auto size = (GLint)    copy.size();
+        // Get raw ptr/size in requested types; glsl data is preprocessed on load
+        auto *ptr = (GLchar *) info.data.data();
+        auto size = (GLint)    info.data.size();
 
         // Submit glsl character data and compile shader
         glShaderSource(object, 1, &ptr, &size);
         glCompileShader(object);
       }
 
-      check_shader_compile(object);
+      // Compile status is checked on resolve, so the driver may compile in parallel
       glAttachShader(program, object);
 
       return object;
@@ -269,58 +270,259 @@ namespace gl {
       glDeleteShader(object);
     }
 
-    GLuint create_program_object(const std::vector<ShaderCreateInfo> &info) {
+    void init_parallel_compile() {
+      gl_trace();
+      static std::once_flag flag;
+      std::call_once(flag, [] {
+        guard(GLAD_GL_KHR_parallel_shader_compile);
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF); // let the driver decide
+      });
+    }
+
+    GLuint submit_program_object(const std::vector<ShaderCreateInfo> &info, std::vector<GLuint> &shader_objects) {
       gl_trace_full();
 
-      GLuint object = glCreateProgram();
+      init_parallel_compile();
 
-      std::vector<GLuint> shader_objects(info.size());
+      GLuint object = glCreateProgram();
 
-      // Generate, compile, and attach shader objects
+      // Generate, submit, and attach shader objects
+      shader_objects.resize(info.size());
       rng::transform(info, shader_objects.begin(),
-        [object](const auto &i) { return attach_shader_object(object, i); });
+        [object](const auto &i) { return submit_shader_object(object, i); });
       
-      // Perform program link
+      // Submit program link; status is checked on resolve
       {
         gl_trace_full_n("Program link");
         glLinkProgram(object);
-        check_program_link(object);
-      }  
+      }
+
+      return object;
+    }
+
+    bool is_program_object_complete(GLuint object) {
+      gl_trace_full();
+      guard(GLAD_GL_KHR_parallel_shader_compile, true);
+      return get_program_iv(object, GL_COMPLETION_STATUS_KHR) == GL_TRUE;
+    }
+
+    void resolve_program_object(GLuint object, std::vector<GLuint> &shader_objects) {
+      gl_trace_full();
+
+      // Check compile status first for a more useful log, then link status
+      rng::for_each(shader_objects, check_shader_compile);
+      check_program_link(object);
 
       // Detach and destroy shader objects
       rng::for_each(shader_objects, 
         [object](const auto &i) { detach_shader_object(object, i); });
+      shader_objects.clear();
+    }
 
-      return object;
+    bool is_sampler_type(GLenum type) {
+      switch (type) {
+        case GL_SAMPLER_1D:                                case GL_SAMPLER_2D:
+        case GL_SAMPLER_3D:                                case GL_SAMPLER_CUBE:
+        case GL_SAMPLER_1D_SHADOW:                         case GL_SAMPLER_2D_SHADOW:
+        case GL_SAMPLER_1D_ARRAY:                          case GL_SAMPLER_2D_ARRAY:
+        case GL_SAMPLER_1D_ARRAY_SHADOW:                   case GL_SAMPLER_2D_ARRAY_SHADOW:
+        case GL_SAMPLER_2D_MULTISAMPLE:                    case GL_SAMPLER_2D_MULTISAMPLE_ARRAY:
+        case GL_SAMPLER_CUBE_SHADOW:                       case GL_SAMPLER_BUFFER:
+        case GL_SAMPLER_2D_RECT:                           case GL_SAMPLER_2D_RECT_SHADOW:
+        case GL_SAMPLER_CUBE_MAP_ARRAY:                    case GL_SAMPLER_CUBE_MAP_ARRAY_SHADOW:
+        case GL_INT_SAMPLER_1D:                            case GL_INT_SAMPLER_2D:
+        case GL_INT_SAMPLER_3D:                            case GL_INT_SAMPLER_CUBE:
+        case GL_INT_SAMPLER_1D_ARRAY:                      case GL_INT_SAMPLER_2D_ARRAY:
+        case GL_INT_SAMPLER_2D_MULTISAMPLE:                case GL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+        case GL_INT_SAMPLER_BUFFER:                        case GL_INT_SAMPLER_2D_RECT:
+        case GL_INT_SAMPLER_CUBE_MAP_ARRAY:                case GL_UNSIGNED_INT_SAMPLER_1D:
+        case GL_UNSIGNED_INT_SAMPLER_2D:                   case GL_UNSIGNED_INT_SAMPLER_3D:
+        case GL_UNSIGNED_INT_SAMPLER_CUBE:                 case GL_UNSIGNED_INT_SAMPLER_1D_ARRAY:
+        case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:             case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE:
+        case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY: case GL_UNSIGNED_INT_SAMPLER_BUFFER:
+        case GL_UNSIGNED_INT_SAMPLER_2D_RECT:              case GL_UNSIGNED_INT_SAMPLER_CUBE_MAP_ARRAY:
+          return true;
+        default:
+          return false;
+      }
     }
 
+    bool is_image_type(GLenum type) {
+      switch (type) {
+        case GL_IMAGE_1D:                                case GL_IMAGE_2D:
+        case GL_IMAGE_3D:                                case GL_IMAGE_2D_RECT:
+        case GL_IMAGE_CUBE:                              case GL_IMAGE_BUFFER:
+        case GL_IMAGE_1D_ARRAY:                          case GL_IMAGE_2D_ARRAY:
+        case GL_IMAGE_CUBE_MAP_ARRAY:                    case GL_IMAGE_2D_MULTISAMPLE:
+        case GL_IMAGE_2D_MULTISAMPLE_ARRAY:              case GL_INT_IMAGE_1D:
+        case GL_INT_IMAGE_2D:                            case GL_INT_IMAGE_3D:
+        case GL_INT_IMAGE_2D_RECT:                       case GL_INT_IMAGE_CUBE:
+        case GL_INT_IMAGE_BUFFER:                        case GL_INT_IMAGE_1D_ARRAY:
+        case GL_INT_IMAGE_2D_ARRAY:                      case GL_INT_IMAGE_CUBE_MAP_ARRAY:
+        case GL_INT_IMAGE_2D_MULTISAMPLE:                case GL_INT_IMAGE_2D_MULTISAMPLE_ARRAY:
+        case GL_UNSIGNED_INT_IMAGE_1D:                   case GL_UNSIGNED_INT_IMAGE_2D:
+        case GL_UNSIGNED_INT_IMAGE_3D:                   case GL_UNSIGNED_INT_IMAGE_2D_RECT:
+        case GL_UNSIGNED_INT_IMAGE_CUBE:                 case GL_UNSIGNED_INT_IMAGE_BUFFER:
+        case GL_UNSIGNED_INT_IMAGE_1D_ARRAY:             case GL_UNSIGNED_INT_IMAGE_2D_ARRAY:
+        case GL_UNSIGNED_INT_IMAGE_CUBE_MAP_ARRAY:       case GL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE:
+        case GL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE_ARRAY:
+          return true;
+        default:
+          return false;
+      }
+    }
+
+    std::vector<uint> get_program_binary_formats() {
+      gl_trace();
+      int n_formats;
+      glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &n_formats);
+      std::vector<uint> formats(n_formats);
+      if (n_formats > 0)
+        glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, reinterpret_cast<int *>(formats.data()));
+      return formats;
+    }
+
+    // Returns 0 if the driver does not support the binary's format, or rejects the binary;
+    // drivers may do so after any update, so this is not treated as an error
     GLuint create_program_object_from_binary(uint format, const std::vector<std::byte> &data) {
+      gl_trace();
+      
+      auto formats = get_program_binary_formats();
+      if (rng::find(formats, format) == formats.end()) {
+        debug::insert_message(fmt::format("Program binary rejected; unsupported format: {}", format),
+                              gl::DebugMessageSeverity::eLow);
+        return 0;
+      }
+
       GLuint object = glCreateProgram();
       glProgramBinary(object, format, data.data(), data.size());
-      check_program_link(object);
+
+      int status;
+      glGetProgramiv(object, GL_LINK_STATUS, &status);
+      if (status == GL_FALSE) {
+        glDeleteProgram(object);
+        debug::insert_message("Program binary rejected by driver", gl::DebugMessageSeverity::eLow);
+        return 0;
+      }
+
       return object;
     }
 
-    FileWatcher create_file_watcher_from_path(const ShaderLoadFileInfo &info) {
-      if (!info.spirv_path.empty()) {
-        return FileWatcher(info.spirv_path);
-      } else if (!info.glsl_path.empty()) {
-        return FileWatcher(info.glsl_path);
-      } else {
-        debug::check_expr(false, "ShaderLoadFileInfo is in an incomplete state.");
+    // Gather files a program depends on, following the load path taken for the given vendor;
+    // on the glsl path, this includes all transitively included files. Makes no gl calls, 
+    // so it may run off the main thread
+    std::vector<fs::path> program_dependencies_from_info(std::span<const ShaderLoadFileInfo> info, VendorType vendor) {
+      gl_trace();
+      std::vector<fs::path> paths;
+      for (const auto &i : info) {
+        if (!i.spirv_path.empty() && vendor != VendorType::eIntel) {
+          paths.push_back(i.spirv_path);
+        } else if (!i.glsl_path.empty()) {
+          auto source   = io::load_string(i.glsl_path);
+          auto includes = preprocess_glsl({ .source       = source,
+                                            .source_path  = i.glsl_path,
+                                            .include_dirs = i.include_dirs,
+                                            .spec_const   = i.spec_const,
+                                            .defines      = i.defines }).includes;
+          paths.push_back(i.glsl_path);
+          rng::copy(includes, std::back_inserter(paths));
+        } else {
+          debug::check_expr(false, "ShaderLoadFileInfo is in an incomplete state.");
+        }
       }
+      
+      // Headers shared between shader stages are watched once
+      rng::sort(paths);
+      paths.erase(std::unique(range_iter(paths)), paths.end());
+      return paths;
     }
 
-    std::vector<FileWatcher> create_file_watchers_from_paths(std::initializer_list<ShaderLoadFileInfo> info) {
+    std::vector<FileWatcher> create_file_watchers_from_paths(std::span<const fs::path> paths) {
       std::vector<FileWatcher> watchers;
-      rng::transform(info, std::back_inserter(watchers), create_file_watcher_from_path);
+      rng::transform(paths, std::back_inserter(watchers), [](const fs::path &path) { return FileWatcher(path); });
       return watchers;
     }
 
-    std::vector<FileWatcher> create_file_watchers_from_paths(const std::vector<ShaderLoadFileInfo> &info) {
-      std::vector<FileWatcher> watchers;
-      rng::transform(info, std::back_inserter(watchers), create_file_watcher_from_path);
-      return watchers;
+    std::vector<FileWatcher> create_file_watchers_from_info(std::span<const ShaderLoadFileInfo> info) {
+      return create_file_watchers_from_paths(program_dependencies_from_info(info, get_vendor()));
+    }
+
+    // Cache file identification; the footer repeats the magic, so truncated files are rejected
+    constexpr uint32_t program_cache_magic       = 0x43474C53; // "SLGC"
+    constexpr uint32_t program_cache_version     = 5;
+    constexpr size_t   program_cache_header_size = 2 * sizeof(uint32_t);                  // magic, version
+    constexpr size_t   program_cache_footer_size = sizeof(uint64_t) + sizeof(uint32_t);   // index offset, magic
+
+    // Warm-up manifest identification
+    constexpr uint32_t program_manifest_magic   = 0x4D574C53; // "SLWM"
+    constexpr uint32_t program_manifest_version = 1;
+
+    // Compression codecs for cache file entries; zlib entries remain readable, but new entries use zstd
+    enum class CacheCodec : uint32_t { eZlib = 0, eZstd = 1 };
+    constexpr CacheCodec program_cache_codec      = CacheCodec::eZstd;
+    constexpr int        program_cache_zstd_level = 3;
+
+    std::vector<std::byte> compress_cache_entry(std::string_view raw, CacheCodec codec) {
+      gl_trace();
+      std::vector<std::byte> data;
+      switch (codec) {
+        case CacheCodec::eZlib: {
+          uLongf size = compressBound(raw.size());
+          data.resize(size);
+          int err = compress2(reinterpret_cast<Bytef *>(data.data()), &size, 
+                              reinterpret_cast<const Bytef *>(raw.data()), raw.size(), Z_BEST_SPEED);
+          debug::check_expr(err == Z_OK, "ProgramCache entry compression failed");
+          data.resize(size);
+          break;
+        }
+        case CacheCodec::eZstd: {
+          data.resize(ZSTD_compressBound(raw.size()));
+          size_t size = ZSTD_compress(data.data(), data.size(), raw.data(), raw.size(), program_cache_zstd_level);
+          debug::check_expr(!ZSTD_isError(size), "ProgramCache entry compression failed");
+          data.resize(size);
+          break;
+        }
+        default:
+          debug::check_expr(false,
+            fmt::format("ProgramCache entry uses unsupported codec: {}", static_cast<uint32_t>(codec)));
+      }
+      return data;
+    }
+
+    // Region of an entry inside a mapped cache file; fails if it exceeds the mapping
+    std::span<const std::byte> cache_entry_data(std::span<const std::byte> file, uint64_t offset, uint64_t size) {
+      debug::check_expr(offset <= file.size() && size <= file.size() - offset,
+        "ProgramCache entry exceeds cache file; the file may be corrupt");
+      return file.subspan(offset, size);
+    }
+
+    std::string decompress_cache_entry(std::span<const std::byte> data, size_t size_raw, CacheCodec codec) {
+      gl_trace();
+
+      // Zstd frames record their size; test it before allocating, as a corrupt index may not
+      if (codec == CacheCodec::eZstd)
+        debug::check_expr(ZSTD_getFrameContentSize(data.data(), data.size()) == size_raw,
+          "ProgramCache entry decompression failed");
+
+      std::string raw(size_raw, '\0');
+      switch (codec) {
+        case CacheCodec::eZlib: {
+          uLongf size = size_raw;
+          int err = uncompress(reinterpret_cast<Bytef *>(raw.data()), &size, 
+                               reinterpret_cast<const Bytef *>(data.data()), data.size());
+          debug::check_expr(err == Z_OK && size == size_raw, "ProgramCache entry decompression failed");
+          break;
+        }
+        case CacheCodec::eZstd: {
+          size_t size = ZSTD_decompress(raw.data(), raw.size(), data.data(), data.size());
+          debug::check_expr(!ZSTD_isError(size) && size == size_raw, "ProgramCache entry decompression failed");
+          break;
+        }
+        default:
+          debug::check_expr(false,
+            fmt::format("ProgramCache entry uses unsupported codec: {}", static_cast<uint32_t>(codec)));
+      }
+      return raw;
     }
   } // namespace detail
 
@@ -336,7 +538,20 @@ namespace gl {
   Program::Program(const ShaderLoadStringInfo &info) 
   : Program({ info }) { }
 
-  Program::Program(std::span<const ShaderLoadFileInfo> load_info) 
+  Program::Program(std::span<const ShaderLoadFileInfo> info)
+  : Program(info, false) { }
+  Program::Program(std::span<const ShaderLoadStringInfo> info)
+  : Program(info, false) { }
+
+  Program Program::make_async(std::span<const ShaderLoadFileInfo> info) {
+    return Program(info, true);
+  }
+
+  Program Program::make_async(std::span<const ShaderLoadStringInfo> info) {
+    return Program(info, true);
+  }
+
+  Program::Program(std::span<const ShaderLoadFileInfo> load_info, bool is_async) 
   : Base(true) {
     gl_trace_full();
     debug::check_expr(load_info.size() > 0, "no shader info was provided");
@@ -359,22 +574,26 @@ namespace gl {
       } else if (!info.glsl_path.empty()) {
         // Fall back to glsl path
         return ShaderCreateInfo { .type     = info.type,  
-                                  .data     = io::load_binary(info.glsl_path), 
+                                  .data     = detail::preprocess_glsl_data(io::load_binary(info.glsl_path), info.glsl_path, info), 
                                   .is_spirv = false };
       } else {
         debug::check_expr(false, "ShaderLoadFileInfo is in an incomplete state.");
       }
     });
     
-    // Initialize program from shader info
-    m_object = detail::create_program_object(create_info);
+    // Initialize program from shader info; compilation may still be in flight
+    m_object = detail::submit_program_object(create_info, m_pending_shaders);
 
     // Handle reflectance data population, if available
     auto filt = load_info | vws::filter([](const auto &info) { return !info.cross_path.empty(); });
     for (const auto &info : filt) populate(info.cross_path);
+
+    // Synchronous construction resolves immediately
+    guard(!is_async);
+    resolve();
   }
 
-  Program::Program(std::span<const ShaderLoadStringInfo> load_info) 
+  Program::Program(std::span<const ShaderLoadStringInfo> load_info, bool is_async) 
   : Base(true) {
     gl_trace_full();
     debug::check_expr(load_info.size() > 0, "no shader info was provided");
@@ -389,29 +608,53 @@ namespace gl {
                                   .spirv_spec_const  = info.spec_const };
       } else if (!info.glsl_data.empty()) {
         return ShaderCreateInfo { .type              = info.type,  
-                                  .data              = info.glsl_data, 
+                                  .data              = detail::preprocess_glsl_data(info.glsl_data, { }, info), 
                                   .is_spirv          = false };
       } else {
         debug::check_expr(false, "ShaderLoadStringInfo is in an incomplete state.");
       }
     });
 
-    // Initialize program
-    m_object = detail::create_program_object(create_info);
+    // Initialize program; compilation may still be in flight
+    m_object = detail::submit_program_object(create_info, m_pending_shaders);
 
     // Handle reflectance data population, if available
     auto filt = load_info | vws::filter([](const auto &info) { return !info.cross_json.empty(); });
     for (const auto &info : filt) populate(info.cross_json);
+
+    // Synchronous construction resolves immediately
+    guard(!is_async);
+    resolve();
   }
 
   Program::~Program() {
     guard(m_is_init);
+    for (GLuint shader : m_pending_shaders)
+      detail::detach_shader_object(m_object, shader);
     glDeleteProgram(m_object);
   }
 
+  bool Program::is_ready() const {
+    gl_trace_full();
+    debug::check_expr(m_is_init, "attempt to use an uninitialized object");
+    guard(is_pending(), true);
+    return detail::is_program_object_complete(m_object);
+  }
+
+  void Program::resolve() {
+    gl_trace_full();
+    debug::check_expr(m_is_init, "attempt to use an uninitialized object");
+    guard(is_pending());
+    detail::resolve_program_object(m_object, m_pending_shaders);
+
+    // Reflect once the program is linked; names provided by .json data take precedence
+    populate();
+  }
+
   void Program::bind() const {
     gl_trace_full();
     debug::check_expr(m_is_init, "attempt to use an uninitialized object");
+    debug::check_expr(!is_pending(), "attempt to bind a program with unresolved compilation; call Program::resolve() first");
     glUseProgram(m_object);
   }
 
@@ -428,28 +671,61 @@ namespace gl {
 
   int Program::loc(std::string_view s) {
     gl_trace_full();
+    resolve();
 
     // Search map for the provided value; reflect if value is not yet located
-    auto f = m_binding_data.find(s.data());
+    auto f = m_binding_data.find(s);
     if (f == m_binding_data.end()) {
-      // Obtain handle and check if it is actually valid
-      GLint handle = glGetUniformLocation(m_object, s.data());
-      debug::check_expr(handle >= 0, 
-        fmt::format("Program::uniform(...) failed with name lookup for uniform name: \"{}\"", s));
+      // Obtain handle and check if it is actually valid; name must be null-terminated here
+      std::string name(s);
+      GLint handle = glGetUniformLocation(m_object, name.c_str());
+      if (handle < 0)
+        debug::check_expr(false,
+          fmt::format("Program::uniform(...) failed with name lookup for uniform name: \"{}\"", s));
 
       BindingData data { .type       = BindingType::eUniform, 
                          .access     = BindingAccess::eReadOnly,
                          .binding    = handle };
-      f = m_binding_data.emplace(s.data(), data).first;
+      f = m_binding_data.emplace(std::move(name), data).first;
     }
 
     // Test extracted value correctness
     const BindingData &data = f->second;
-    debug::check_expr(data.type == BindingType::eUniform,
-      fmt::format("Program::bind(...) failed with type mismatch for buffer name: \"{}\"", s));
+    if (data.type != BindingType::eUniform)
+      debug::check_expr(false,
+        fmt::format("Program::bind(...) failed with type mismatch for buffer name: \"{}\"", s));
 
     return data.binding;
   }
+
+  int Program::loc(const BindingHandle &h) const {
+    gl_trace();
+    if (h.type != BindingType::eUniform)
+      debug::check_expr(false,
+        fmt::format("Program::uniform(...) failed with type mismatch for uniform at location: {}", h.binding));
+    return h.binding;
+  }
+
+  const Program::BindingData & Program::lookup(std::string_view s) const {
+    gl_trace();
+    auto f = m_binding_data.find(s);
+    if (f == m_binding_data.end())
+      debug::check_expr(false,
+        fmt::format("Program::bind(...) failed with name lookup for name: \"{}\"", s));
+    return f->second;
+  }
+
+  Program::BindingHandle Program::handle(std::string_view s) {
+    gl_trace_full();
+    resolve();
+
+    // Reflected names are returned directly; otherwise, fall back to a classic uniform location
+    auto f = m_binding_data.find(s);
+    if (f != m_binding_data.end())
+      return f->second;
+    loc(s);
+    return lookup(s);
+  }
   
   void Program::populate(fs::path refl_path) {
     gl_trace_full();
@@ -493,32 +769,135 @@ namespace gl {
       rng::for_each(js.at("images"), std::bind(func_qualifier, _1, BindingType::eImage));
   }
 
-  void Program::bind(std::string_view s, const gl::AbstractTexture &texture, const gl::Sampler &sampler, BindingType binding) {
+  void Program::populate() {
     gl_trace_full();
 
-    auto f = m_binding_data.find(s.data());
-    debug::check_expr(f != m_binding_data.end(),
-      fmt::format("Program::bind(...) failed with name lookup for texture name: \"{}\"", s));
+    // Query properties of all active resources in an interface, and pass these alongside their
+    // indices and names to f; GL_NAME_LENGTH is always queried first. Array names are reflected as "name[0]",
+    // and are stripped so arrays are accessed by plain name. Resources without names, e.g. 
+    // from SPIR-V binaries without debug info, are skipped
+    auto for_each_resource = [&](GLenum interface, std::span<const GLenum> props, auto f) {
+      std::vector<GLenum> all_props = { GL_NAME_LENGTH };
+      rng::copy(props, std::back_inserter(all_props));
+      std::vector<GLint> values(all_props.size());
       
-    const BindingData &data = f->second;
-    debug::check_expr(data.type == BindingType::eSampler,
-      fmt::format("Program::bind(...) failed with type mismatch for texture name: \"{}\"", s));
-    
-    texture.bind_to(gl::TextureTargetType::eTextureUnit, data.binding, 0);
-    sampler.bind_to(data.binding);
+      GLint n_resources;
+      glGetProgramInterfaceiv(m_object, interface, GL_ACTIVE_RESOURCES, &n_resources);
+      for (GLint i = 0; i < n_resources; ++i) {
+        glGetProgramResourceiv(m_object, interface, i, 
+          all_props.size(), all_props.data(), values.size(), nullptr, values.data());
+        guard_continue(values[0] > 1);
+        
+        std::string name(values[0], '\0');
+        glGetProgramResourceName(m_object, interface, i, name.size(), nullptr, name.data());
+        name.resize(values[0] - 1); // Strip null terminator
+        if (name.ends_with("[0]"))
+          name.resize(name.size() - 3);
+
+        f(i, std::move(name), std::span<const GLint>(values).subspan(1));
+      }
+    };
+
+    // Uniform and storage blocks; block bindings are kept for their members below
+    std::vector<GLint> ubo_bindings, ssbo_bindings;
+    for (auto [interface, type, bindings] : { std::tuple { GL_UNIFORM_BLOCK,        BindingType::eUniformBuffer, &ubo_bindings  },
+                                              std::tuple { GL_SHADER_STORAGE_BLOCK, BindingType::eStorageBuffer, &ssbo_bindings } }) {
+      GLint n_blocks;
+      glGetProgramInterfaceiv(m_object, interface, GL_ACTIVE_RESOURCES, &n_blocks);
+      bindings->resize(n_blocks, -1);
+
+      constexpr std::array<GLenum, 1> props = { GL_BUFFER_BINDING };
+      for_each_resource(interface, props, [&](GLint i, std::string &&name, std::span<const GLint> values) {
+        (*bindings)[i] = values[0];
+        m_binding_data.emplace(std::move(name), BindingData { .type    = type, 
+                                                              .access  = BindingAccess::eReadWrite,
+                                                              .binding = values[0] });
+      });
+    }
+
+    // Uniforms; default block uniforms are split into samplers, images, and classic uniforms
+    {
+      constexpr std::array<GLenum, 5> props = { GL_TYPE, GL_LOCATION, GL_BLOCK_INDEX, GL_OFFSET, GL_ARRAY_STRIDE };
+      for_each_resource(GL_UNIFORM, props, [&](GLint, std::string &&name, std::span<const GLint> values) {
+        auto [type, location, block_index, offset, array_stride] = std::tuple { values[0], values[1], values[2], values[3], values[4] };
+        
+        BindingData data;
+        if (block_index != -1) {
+          data = { .type         = BindingType::eMember, 
+                   .access       = BindingAccess::eReadOnly,
+                   .binding      = ubo_bindings[block_index], 
+                   .offset       = offset, 
+                   .array_stride = array_stride };
+        } else if (detail::is_sampler_type(type) || detail::is_image_type(type)) {
+          // Binding is the value of the opaque uniform, as set by layout(binding = ...)
+          GLint binding;
+          glGetUniformiv(m_object, location, &binding);
+          bool is_sampler = detail::is_sampler_type(type);
+          data = { .type    = is_sampler ? BindingType::eSampler : BindingType::eImage,
+                   .access  = is_sampler ? BindingAccess::eReadOnly : BindingAccess::eReadWrite,
+                   .binding = binding };
+        } else {
+          data = { .type    = BindingType::eUniform, 
+                   .access  = BindingAccess::eReadOnly,
+                   .binding = location };
+        }
+        m_binding_data.emplace(std::move(name), data);
+      });
+    }
+
+    // Storage block members; runtime-sized arrays of structs only report a top-level stride
+    {
+      constexpr std::array<GLenum, 4> props = { GL_BLOCK_INDEX, GL_OFFSET, GL_ARRAY_STRIDE, GL_TOP_LEVEL_ARRAY_STRIDE };
+      for_each_resource(GL_BUFFER_VARIABLE, props, [&](GLint, std::string &&name, std::span<const GLint> values) {
+        auto [block_index, offset, array_stride, top_level_stride] = std::tuple { values[0], values[1], values[2], values[3] };
+        m_binding_data.emplace(std::move(name), BindingData { .type         = BindingType::eMember, 
+                                                              .access       = BindingAccess::eReadWrite,
+                                                              .binding      = ssbo_bindings[block_index], 
+                                                              .offset       = offset, 
+                                                              .array_stride = array_stride ? array_stride : top_level_stride });
+      });
+    }
   }
 
+  void Program::bind(std::string_view s, const gl::AbstractTexture &texture, const gl::Sampler &sampler, BindingType binding) {
+    gl_trace_full();
+    resolve();
+    bind(lookup(s), texture, sampler);
+  }
   
   void Program::bind(std::string_view s, const gl::AbstractTexture &texture, BindingType binding) {
     gl_trace_full();
+    resolve();
+    bind(lookup(s), texture);
+  }
 
-    auto f = m_binding_data.find(s.data());
-    debug::check_expr(f != m_binding_data.end(),
-      fmt::format("Program::bind(...) failed with name lookup for texture name: \"{}\"", s));
-      
-    const BindingData &data = f->second;
-    debug::check_expr(data.type == BindingType::eSampler || data.type == BindingType::eImage,
-      fmt::format("Program::bind(...) failed with type mismatch for texture name: \"{}\"", s));
+  void Program::bind(std::string_view s, const gl::Buffer &buffer, size_t size, size_t offset, BindingType binding) {
+    gl_trace_full();
+    resolve();
+    bind(lookup(s), buffer, size, offset);
+  }
+
+  void Program::bind(std::string_view s, const gl::Sampler &sampler, BindingType binding) {
+    gl_trace_full();
+    resolve();
+    bind(lookup(s), sampler);
+  }
+
+  void Program::bind(const BindingHandle &data, const gl::AbstractTexture &texture, const gl::Sampler &sampler) const {
+    gl_trace_full();
+    if (data.type != BindingType::eSampler)
+      debug::check_expr(false,
+        fmt::format("Program::bind(...) failed with type mismatch for texture at binding: {}", data.binding));
+    
+    texture.bind_to(gl::TextureTargetType::eTextureUnit, data.binding, 0);
+    sampler.bind_to(data.binding);
+  }
+
+  void Program::bind(const BindingHandle &data, const gl::AbstractTexture &texture) const {
+    gl_trace_full();
+    if (data.type != BindingType::eSampler && data.type != BindingType::eImage)
+      debug::check_expr(false,
+        fmt::format("Program::bind(...) failed with type mismatch for texture at binding: {}", data.binding));
 
     if (data.type == BindingType::eSampler) {
       texture.bind_to(gl::TextureTargetType::eTextureUnit, data.binding, 0);
@@ -537,17 +916,11 @@ namespace gl {
     }
   }
 
-  void Program::bind(std::string_view s, const gl::Buffer &buffer, size_t size, size_t offset, BindingType binding) {
+  void Program::bind(const BindingHandle &data, const gl::Buffer &buffer, size_t size, size_t offset) const {
     gl_trace_full();
-
-    auto f = m_binding_data.find(s.data());
-    debug::check_expr(f != m_binding_data.end(),
-      fmt::format("Program::bind(...) failed with name lookup for buffer name: \"{}\"", s));
-
-    const BindingData &data = f->second;
-    debug::check_expr(
-      data.type == BindingType::eUniformBuffer || data.type == BindingType::eStorageBuffer,
-      fmt::format("Program::bind(...) failed with type mismatch for buffer name: \"{}\"", s));
+    if (data.type != BindingType::eUniformBuffer && data.type != BindingType::eStorageBuffer)
+      debug::check_expr(false,
+        fmt::format("Program::bind(...) failed with type mismatch for buffer at binding: {}", data.binding));
 
     // TODO; expand secondary types
     auto target = data.type == BindingType::eUniformBuffer 
@@ -556,23 +929,18 @@ namespace gl {
     buffer.bind_to(target, data.binding, size, offset);
   }
 
-  void Program::bind(std::string_view s, const gl::Sampler &sampler, BindingType binding) {
+  void Program::bind(const BindingHandle &data, const gl::Sampler &sampler) const {
     gl_trace_full();
-
-    auto f = m_binding_data.find(s.data());
-    debug::check_expr(f != m_binding_data.end(),
-      fmt::format("Program::bind(...) failed with name lookup for sampler name: \"{}\"", s));
-      
-    const BindingData &data = f->second;
-    debug::check_expr(
-      data.type == BindingType::eSampler,
-      fmt::format("Program::bind(...) failed with type mismatch for sampler name: \"{}\"", s));
+    if (data.type != BindingType::eSampler)
+      debug::check_expr(false,
+        fmt::format("Program::bind(...) failed with type mismatch for sampler at binding: {}", data.binding));
     
     sampler.bind_to(data.binding);
   }
   
   void Program::to_stream(std::ostream &str) const {
     gl_trace();
+    debug::check_expr(!is_pending(), "attempt to serialize a program with unresolved compilation");
 
     // Get program binary length
     int program_length;
@@ -599,60 +967,213 @@ namespace gl {
     io::from_stream(program_data, str);
     io::from_stream(m_binding_data, str);
     
-    // Instantiate program and assume ownersip over resulting object handle
-    m_is_init = true;
+    // Instantiate program and assume ownersip over resulting object handle;
+    // if the driver rejects the binary, the program is left uninitialized
     m_object  = detail::create_program_object_from_binary(program_format, program_data);
+    m_is_init = m_object != 0;
   }
 
   void ShaderLoadFileInfo::to_stream(std::ostream &str) const {
     gl_trace();
-    io::to_stream(type,       str);
-    io::to_stream(glsl_path,  str);
-    io::to_stream(spirv_path, str);
-    io::to_stream(cross_path, str);
-    io::to_stream(spec_const, str);
+    io::to_stream(type,         str);
+    io::to_stream(glsl_path,    str);
+    io::to_stream(spirv_path,   str);
+    io::to_stream(cross_path,   str);
+    io::to_stream(spec_const,   str);
+    io::to_stream(defines,      str);
+    io::to_stream(include_dirs, str);
   }
 
   void ShaderLoadFileInfo::from_stream(std::istream &str) {
     gl_trace();
-    io::from_stream(type,       str);
-    io::from_stream(glsl_path,  str);
-    io::from_stream(spirv_path, str);
-    io::from_stream(cross_path, str);
-    io::from_stream(spec_const, str);
+    io::from_stream(type,         str);
+    io::from_stream(glsl_path,    str);
+    io::from_stream(spirv_path,   str);
+    io::from_stream(cross_path,   str);
+    io::from_stream(spec_const,   str);
+    io::from_stream(defines,      str);
+    io::from_stream(include_dirs, str);
   }
 
   void ProgramCache::ProgramData::to_stream(std::ostream &str) const {
     gl_trace();
     io::to_stream(info,     str);
-    io::to_stream(program,  str);
+    io::to_stream(hash,     str);
     io::to_stream(watchers, str);
+
+    // Program binary is stored as a sized blob, so stale entries can be skipped on load
+    std::ostringstream program_str(std::ios::binary);
+    if (program.is_init())
+      io::to_stream(program, program_str);
+    io::to_stream(program_str.str(), str);
   }
 
   void ProgramCache::ProgramData::from_stream(std::istream &str) {
     gl_trace();
     io::from_stream(info,     str);
-    io::from_stream(program,  str);
+    io::from_stream(hash,     str);
     io::from_stream(watchers, str);
+
+    // Program binary is only instantiated once the entry is validated against current files
+    io::from_stream(binary,   str);
+  }
+
+  void ProgramCache::update(const std::string &key, ProgramData &data) {
+    gl_trace();
+
+    // Only confirm changes through file watchers if the file monitor reported any; 
+    // watchers only register content changes, not touched files
+    bool is_stale = !data.program.is_init();
+    if (data.is_stale) {
+      for (auto &watcher : data.watchers)
+        is_stale |= watcher.update();
+      data.is_stale = false;
+    }
+
+    // Rebuild program if necessary; includes may have changed, so dependencies are gathered anew
+    if (is_stale) {
+      data.program  = Program(data.info);
+      data.hash     = program_hash_from_info(data.info);
+      data.watchers = detail::create_file_watchers_from_info(data.info);
+      data.is_dirty = true;
+      monitor(key, data);
+    }
+
+    // Check status of programs submitted asynchronously by set(...)
+    data.program.resolve();
+  }
+
+  void ProgramCache::refresh() {
+    gl_trace();
+
+    // Flag programs with changed files as stale, and gather these
+    poll_monitor();
+    std::vector<std::pair<const std::string, ProgramData> *> stale;
+    for (auto &entry : m_data_cache)
+      if (entry.second.is_stale)
+        stale.push_back(&entry);
+    guard(!stale.empty());
+
+    // Confirm changes, and gather new dependencies and watchers, in parallel; this only touches
+    // the filesystem, and preprocessed glsl sources are cached for the rebuild below. Watchers
+    // are updated on copies, and exceptions cannot leave the parallel region, so an entry that
+    // fails (e.g. a file mid-save) is left untouched and stale, and is retried on the next call
+    std::vector<uint> is_changed(stale.size(), 0);
+    std::vector<uint> is_failed(stale.size(), 0);
+    std::vector<std::vector<detail::FileWatcher>> watchers(stale.size());
+    auto vendor = get_vendor();
+    #pragma omp parallel for
+    for (int i = 0; i < static_cast<int>(stale.size()); ++i) {
+      const auto &data = stale[i]->second;
+      try {
+        watchers[i] = data.watchers;
+        for (auto &watcher : watchers[i])
+          is_changed[i] |= watcher.update();
+        if (is_changed[i])
+          watchers[i] = detail::create_file_watchers_from_paths(
+            detail::program_dependencies_from_info(data.info, vendor));
+      } catch (const std::exception &) {
+        is_changed[i] = 0;
+        is_failed[i]  = 1;
+      }
+    }
+
+    // Submit all affected programs into temporaries before checking any status, so the driver
+    // may compile in parallel; working programs are only replaced once their rebuild succeeds
+    std::vector<Program> programs(stale.size());
+    for (uint i = 0; i < stale.size(); ++i) {
+      guard_continue(!is_failed[i]);
+      auto &[key, data] = *stale[i];
+      data.watchers = std::move(watchers[i]);
+      if (!is_changed[i]) {
+        data.is_stale = false;
+        continue;
+      }
+      monitor(key, data);
+      programs[i] = Program::make_async(data.info);
+    }
+
+    // Resolve each rebuild; a failed rebuild keeps the previous program, and leaves its entry
+    // stale, so later edits to any dependency trigger a new attempt. The first error is 
+    // rethrown once all other entries are handled
+    std::exception_ptr error;
+    for (uint i = 0; i < stale.size(); ++i) {
+      guard_continue(is_changed[i]);
+      auto &data = stale[i]->second;
+      try {
+        programs[i].resolve();
+        data.program  = std::move(programs[i]);
+        data.hash     = program_hash_from_info(data.info);
+        data.is_dirty = true;
+        data.is_stale = false;
+      } catch (...) {
+        if (!error)
+          error = std::current_exception();
+      }
+    }
+    if (error)
+      std::rethrow_exception(error);
+  }
+
+  void ProgramCache::monitor(const std::string &key, const ProgramData &data) {
+    gl_trace();
+
+    // Start file monitor on first use, so caches without file-based programs spawn no thread
+    if (!m_monitor.is_init())
+      m_monitor = detail::FileMonitor(false);
+
+    // Register key with each dependency; the same key is registered only once per file
+    for (const auto &watcher : data.watchers) {
+      guard_continue(fs::exists(watcher.path()));
+      auto &keys = m_monitor_keys[m_monitor.watch(watcher.path())];
+      if (rng::find(keys, key) == keys.end())
+        keys.push_back(key);
+    }
+  }
+
+  void ProgramCache::poll_monitor() {
+    gl_trace();
+
+    // Flag programs depending on changed files as stale
+    bool is_complete = m_monitor.drain([&](uint id) {
+      auto f = m_monitor_keys.find(id);
+      guard(f != m_monitor_keys.end());
+      for (const auto &key : f->second)
+        if (auto it = m_data_cache.find(key); it != m_data_cache.end())
+          it->second.is_stale = true;
+    });
+
+    // If events were dropped, conservatively flag all programs as stale
+    if (!is_complete)
+      for (auto &[key, data] : m_data_cache)
+        data.is_stale = true;
   }
 
   std::pair<std::string, gl::Program &> ProgramCache::set(InfoType &&info) {
     gl_trace();
 
-    // Generate key, and test if program is resident
+    // Generate key, and test if program is resident or in the mapped cache file
     auto key = info.to_string();
     auto it  = m_data_cache.find(key);
+    if (it == m_data_cache.end())
+      it = fetch(key, std::span(&info, 1));
 
     // If program is not resident, generate program, then cache it
     if (it == m_data_cache.end()) {
       ProgramData data = {
         .info     = { info },
+        .hash     = program_hash_from_info(std::span(&info, 1)),
         .program  = gl::Program(info),
-        .watchers = { detail::create_file_watcher_from_path(info) }
+        .watchers = detail::create_file_watchers_from_info(std::span(&info, 1))
       };
       it = m_data_cache.emplace(key, std::move(data)).first;
+      monitor(it->first, it->second);
+    } else {
+      poll_monitor();
+      update(it->first, it->second);
     }
 
+    record(it->first, it->second);
     return { key, it->second.program };
   }
 
@@ -660,69 +1181,593 @@ namespace gl {
     gl_trace();
 
     // Generate key from join of consecutive info object keys
-    auto in = info | vws::transform([](const auto &i) { return i.to_string(); }) | vws::join;
-    std::string key;
-    rng::copy(in, std::back_inserter(key));
+    auto key = program_key_from_info(info);
 
-    // Test if program is resident
+    // Test if program is resident or in the mapped cache file
     auto it  = m_data_cache.find(key);
+    if (it == m_data_cache.end())
+      it = fetch(key, info);
 
     // If program is not resident, generate program, then cache it
     if (it == m_data_cache.end()) {
       ProgramData data = {
         .info     = info,
+        .hash     = program_hash_from_info(info),
         .program  = gl::Program(info),
-        .watchers = detail::create_file_watchers_from_paths(info)
+        .watchers = detail::create_file_watchers_from_info(info)
       };
       it = m_data_cache.emplace(key, std::move(data)).first;
+      monitor(it->first, it->second);
+    } else {
+      poll_monitor();
+      update(it->first, it->second);
     }
 
+    record(it->first, it->second);
     return { key, it->second.program };
   }
 
+  std::vector<std::pair<std::string, gl::Program &>> ProgramCache::set(std::span<const std::vector<InfoType>> info, bool resolve) {
+    gl_trace();
+
+    // Generate keys, and decompress all indexed entries in the mapped cache file in parallel
+    auto keys = info | vws::transform([](const auto &i) { return program_key_from_info(i); }) | view_to<std::vector<std::string>>();
+    fetch(keys, info);
+
+    // Submit all non-resident programs before checking any status
+    for (uint i = 0; i < info.size(); ++i) {
+      const auto &program_info = info[i];
+      const auto &key          = keys[i];
+      auto it = m_data_cache.find(key);
+      if (it == m_data_cache.end()) {
+        ProgramData data = {
+          .info     = program_info,
+          .hash     = program_hash_from_info(program_info),
+          .program  = gl::Program::make_async(program_info),
+          .watchers = detail::create_file_watchers_from_info(program_info)
+        };
+        it = m_data_cache.emplace(key, std::move(data)).first;
+        monitor(it->first, it->second);
+      } else if (!it->second.program.is_init()) {
+        // Entry was invalidated on load; resubmit alongside the rest of the batch
+        it->second.program  = gl::Program::make_async(program_info);
+        it->second.hash     = program_hash_from_info(program_info);
+        it->second.is_dirty = true;
+      }
+    }
+
+    // Resolve in submission order; later programs keep compiling in the meantime
+    std::vector<std::pair<std::string, gl::Program &>> programs;
+    programs.reserve(keys.size());
+    for (auto &key : keys) {
+      auto &data = m_data_cache.at(key);
+      if (resolve)
+        data.program.resolve();
+      record(key, data);
+      programs.push_back({ std::move(key), data.program });
+    }
+
+    return programs;
+  }
+
   gl::Program & ProgramCache::at(const std::string &k) {
     gl_trace();
+
+    // Flag programs with changed files as stale; a single atomic load if nothing changed
+    poll_monitor();
     
-    // Find program data in cache
+    // Find program data in cache, or in the mapped cache file
     auto f = m_data_cache.find(k);
-    debug::check_expr(f != m_data_cache.end(),
-      fmt::format("ProgramCache::at(...) failed with key lookup for key: \"{}\"", k));
+    if (f == m_data_cache.end())
+      f = fetch(k);
+    if (f == m_data_cache.end())
+      debug::check_expr(false,
+        fmt::format("ProgramCache::at(...) failed with key lookup for key: \"{}\"", k));
     auto &data = f->second;
 
-    // Check file watcher, rebuild program if necessary
-    bool is_stale = false;
-    for (auto &watcher : data.watchers)
-      is_stale |= watcher.update();
-    if (is_stale)
-      data.program = Program(data.info);
+    // Rebuild program if necessary
+    update(f->first, data);
+    record(f->first, data);
 
     return data.program;
   }
 
+  void ProgramCache::record(const std::string &key, const ProgramData &data) {
+    gl_trace();
+    guard(m_is_recording);
+    if (m_manifest_keys.insert(key).second)
+      m_manifest.push_back(data.info);
+  }
+
+  void ProgramCache::start_recording() {
+    gl_trace();
+    m_is_recording = true;
+  }
+
+  void ProgramCache::stop_recording() {
+    gl_trace();
+    m_is_recording = false;
+  }
+
+  void ProgramCache::save_manifest(fs::path manifest_path) const {
+    gl_trace();
+    
+    std::ofstream str(manifest_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    debug::check_expr(str.good(),
+      fmt::format("Program cache cannot save manifest to: {}", manifest_path.string()));
+    io::to_stream(detail::program_manifest_magic,   str);
+    io::to_stream(detail::program_manifest_version, str);
+    io::to_stream(m_manifest,                       str);
+
+    debug::insert_message(
+      fmt::format("Program cache manifest of {} programs saved to: {}", m_manifest.size(), manifest_path.string()), 
+      gl::DebugMessageSeverity::eLow);
+  }
+
+  ProgramCache::WarmupData ProgramCache::warm_up(fs::path manifest_path, bool dummy_dispatch) {
+    gl_trace();
+    auto time_begin = std::chrono::steady_clock::now();
+    
+    // Read manifest; incompatible manifests are ignored, as warm-up is an optimization only
+    std::vector<std::vector<InfoType>> manifest;
+    {
+      debug::check_expr(fs::exists(manifest_path),
+        fmt::format("Program cache cannot warm up; manifest does not exist at: {}", manifest_path.string()));
+      std::ifstream str(manifest_path, std::ios::in | std::ios::binary);
+      uint32_t magic = 0, version = 0;
+      io::from_stream(magic,   str);
+      io::from_stream(version, str);
+      if (magic != detail::program_manifest_magic || version != detail::program_manifest_version) {
+        debug::insert_message(
+          fmt::format("Program cache manifest ignored; incompatible manifest at: {}", manifest_path.string()), 
+          gl::DebugMessageSeverity::eLow);
+        return { };
+      }
+      io::from_stream(manifest, str);
+    }
+
+    // Skip programs of which files have since been removed
+    std::erase_if(manifest, [](const auto &info) {
+      return rng::any_of(info, [](const InfoType &i) {
+        return (!i.glsl_path.empty() && !fs::exists(i.glsl_path)) || (!i.spirv_path.empty() && !fs::exists(i.spirv_path));
+      });
+    });
+
+    // Note programs already resident, so only programs compiled by this call are counted
+    std::unordered_set<std::string> resident;
+    for (const auto &info : manifest)
+      if (auto f = m_data_cache.find(program_key_from_info(info)); f != m_data_cache.end() && f->second.program.is_init())
+        resident.insert(f->first);
+
+    // Instantiate all programs as a batch; cached binaries are decompressed in parallel, and
+    // remaining programs are all submitted before any is resolved, so the driver may compile
+    // them in parallel
+    auto programs = set(manifest, true);
+    
+    // Issue a minimal draw per graphics program, so the driver finalizes state up front; draws
+    // are made with rasterization disabled, and with a primitive type the program's first stage 
+    // accepts. Compute programs are skipped, as a dispatch may write to bound resources
+    if (dummy_dispatch) {
+      GLuint array;
+      glCreateVertexArrays(1, &array);
+      glBindVertexArray(array);
+      {
+        state::ScopedSet scope(DrawCapability::eRasterizerDiscard, true);
+        for (uint i = 0; i < programs.size(); ++i) {
+          auto has_stage = [&](ShaderType type) { 
+            return rng::any_of(manifest[i], [type](const auto &i) { return i.type == type; }); 
+          };
+          guard_continue(!has_stage(ShaderType::eCompute));
+          
+          auto &program = programs[i].second;
+          program.bind();
+
+          // Tessellation requires patches; geometry shaders require their declared input type
+          GLint mode = GL_POINTS, count = 1;
+          if (has_stage(ShaderType::eTesselationCtrl) || has_stage(ShaderType::eTesselationEval)) {
+            mode = GL_PATCHES;
+            glGetIntegerv(GL_PATCH_VERTICES, &count);
+          } else if (has_stage(ShaderType::eGeometry)) {
+            glGetProgramiv(program.object(), GL_GEOMETRY_INPUT_TYPE, &mode);
+            switch (mode) {
+              case GL_LINES:               count = 2; break;
+              case GL_LINES_ADJACENCY:     count = 4; break;
+              case GL_TRIANGLES:           count = 3; break;
+              case GL_TRIANGLES_ADJACENCY: count = 6; break;
+              default:                     count = 1; break;
+            }
+          }
+          glDrawArrays(mode, 0, count);
+        }
+      }
+      glBindVertexArray(0);
+      glDeleteVertexArrays(1, &array);
+      glUseProgram(0);
+    }
+
+    WarmupData data = {
+      .n_programs = programs.size(),
+      .n_compiled = static_cast<size_t>(rng::count_if(programs, [&](const auto &p) { 
+        return !resident.contains(p.first) && m_data_cache.at(p.first).is_dirty; 
+      })),
+      .duration   = std::chrono::steady_clock::now() - time_begin
+    };
+    
+    debug::insert_message(
+      fmt::format("Program cache warmed up {} programs ({} compiled) in {} ms", 
+                  data.n_programs, data.n_compiled, data.duration.count()), 
+      gl::DebugMessageSeverity::eLow);
+    return data;
+  }
+
+  std::chrono::duration<float, std::milli> ProgramCache::mark_first_frame() {
+    gl_trace();
+    auto duration = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - m_time_begin);
+    debug::insert_message(
+      fmt::format("Program cache time-to-first-frame: {} ms, with {} resident programs", 
+                  duration.count(), m_data_cache.size()), 
+      gl::DebugMessageSeverity::eLow);
+    return duration;
+  }
+
   void ProgramCache::reload() {
     gl_trace();
+    // Submit all programs before checking any status, so the driver may compile in parallel
     for (auto &[key, data] : m_data_cache) {
-      data.program = Program(data.info);
-    } 
+      data.program  = Program::make_async(data.info);
+      data.hash     = program_hash_from_info(data.info);
+      data.is_dirty = true;
+    }
+    for (auto &[key, data] : m_data_cache)
+      data.program.resolve();
   }
 
   void ProgramCache::clear() {
     gl_trace();
     m_data_cache.clear();
+    m_file_index.clear();
+    m_file_keys.clear();
+    m_file      = { };
+    m_file_path.clear();
+    m_monitor   = { };
+    m_monitor_keys.clear();
   }
 
   ProgramCache::ProgramCache(fs::path cache_file_path) { load(cache_file_path); }
 
-  void ProgramCache::save(fs::path cache_file_path) const {
+  void ProgramCache::IndexData::to_stream(std::ostream &str) const {
     gl_trace();
+    io::to_stream(key,         str);
+    io::to_stream(offset,      str);
+    io::to_stream(size,        str);
+    io::to_stream(size_raw,    str);
+    io::to_stream(codec,       str);
+    io::to_stream(driver_hash, str);
+  }
 
-    // Attempt opening zlib compressed stream
-    constexpr auto str_flags = std::ios::out | std::ios::binary | std::ios::trunc;
-    auto str = zstr::ofstream(cache_file_path.string(), str_flags, Z_BEST_SPEED);
-    debug::check_expr(str.good());
+  void ProgramCache::IndexData::from_stream(std::istream &str) {
+    gl_trace();
+    io::from_stream(key,         str);
+    io::from_stream(offset,      str);
+    io::from_stream(size,        str);
+    io::from_stream(size_raw,    str);
+    io::from_stream(codec,       str);
+    io::from_stream(driver_hash, str);
+  }
+
+  detail::string_map<ProgramCache::IndexData>::iterator ProgramCache::find_file_entry(std::string_view key, std::span<const InfoType> info) {
+    gl_trace();
+    guard(!m_file_index.empty(), m_file_index.end());
 
-    // Serialize program cache to stream
-    io::to_stream(m_data_cache, str);
+    // Find entry by content hash of the given info, so copies of a cache remain valid under other paths
+    if (!info.empty())
+      return m_file_index.find(program_hash_key(program_hash_from_info(info)));
+
+    // Otherwise, find entry by key of the program that wrote it
+    auto k = m_file_keys.find(key);
+    guard(k != m_file_keys.end(), m_file_index.end());
+    return m_file_index.find(k->second);
+  }
+
+  detail::string_map<ProgramCache::ProgramData>::iterator ProgramCache::fetch(std::string_view key, std::span<const InfoType> info) {
+    gl_trace();
+    
+    auto f = find_file_entry(key, info);
+    guard(f != m_file_index.end(), m_data_cache.end());
+
+    // Decompress entry from mapped file
+    const auto &index = f->second;
+    auto raw = detail::decompress_cache_entry(detail::cache_entry_data(m_file.data(), index.offset, index.size), 
+                                              index.size_raw, 
+                                              static_cast<detail::CacheCodec>(index.codec));
+    
+    return instantiate(f, std::move(raw), key, info);
+  }
+
+  void ProgramCache::fetch(std::span<const std::string> keys, std::span<const std::vector<InfoType>> info) {
+    gl_trace();
+
+    // Gather entries that are indexed, but not yet resident, alongside the index of their request
+    std::vector<std::pair<detail::string_map<IndexData>::iterator, uint>> requests;
+    for (uint i = 0; i < keys.size(); ++i) {
+      guard_continue(!m_data_cache.contains(keys[i]));
+      auto f = find_file_entry(keys[i], info.empty() ? std::span<const InfoType>() : info[i]);
+      if (f != m_file_index.end())
+        requests.push_back({ f, i });
+    }
+    rng::sort(requests, {}, [](const auto &r) { return r.first->second.offset; });
+    requests.erase(std::unique(range_iter(requests), [](const auto &a, const auto &b) { return a.first == b.first; }), 
+                   requests.end());
+    guard(!requests.empty());
+    auto fetched = requests | vws::keys | view_to<std::vector<detail::string_map<IndexData>::iterator>>();
+
+    // Decompress entries in parallel; only the mapped file is accessed here. Exceptions cannot
+    // leave the parallel region, so errors are caught per entry
+    std::vector<std::string> raw(fetched.size());
+    std::vector<uint>        is_corrupt(fetched.size(), 0);
+    #pragma omp parallel for
+    for (int i = 0; i < static_cast<int>(fetched.size()); ++i) {
+      const auto &index = fetched[i]->second;
+      try {
+        raw[i] = detail::decompress_cache_entry(detail::cache_entry_data(m_file.data(), index.offset, index.size), 
+                                                index.size_raw, 
+                                                static_cast<detail::CacheCodec>(index.codec));
+      } catch (const std::exception &) {
+        is_corrupt[i] = 1;
+      }
+    }
+
+    // Deserialize and instantiate program binaries on the calling thread, which owns the context;
+    // corrupt entries are dropped from the index, and recompiled on use
+    uint n_corrupt = 0;
+    for (uint i = 0; i < fetched.size(); ++i) {
+      uint j = requests[i].second;
+      if (is_corrupt[i]) {
+        m_file_keys.erase(fetched[i]->second.key);
+        m_file_index.erase(fetched[i]);
+        n_corrupt++;
+      } else {
+        instantiate(fetched[i], std::move(raw[i]), keys[j], info.empty() ? std::span<const InfoType>() : info[j]);
+      }
+    }
+    if (n_corrupt > 0) {
+      debug::insert_message(
+        fmt::format("Program cache dropped {} corrupt entries; these will be recompiled on use", n_corrupt), 
+        gl::DebugMessageSeverity::eLow);
+    }
+  }
+
+  detail::string_map<ProgramCache::ProgramData>::iterator 
+  ProgramCache::instantiate(detail::string_map<IndexData>::iterator f, std::string &&raw, 
+                            std::string_view key, std::span<const InfoType> info) {
+    gl_trace();
+
+    // Deserialize entry
+    std::istringstream str(std::move(raw), std::ios::binary);
+    ProgramData data;
+    io::from_stream(data, str);
+    data.is_dirty = false;
+
+    // Entries found by content hash are valid, and take over the file paths of the given info; 
+    // entries found by key share their paths, but must be tested against current file contents
+    auto driver_id = get_driver_id();
+    bool is_valid  = f->second.driver_hash == io::hash_bytes(std::as_bytes(std::span(driver_id)));
+    if (!info.empty()) {
+      data.info     = { range_iter(info) };
+      data.watchers = detail::create_file_watchers_from_info(info);
+    } else if (is_valid) {
+      try {
+        is_valid = data.hash == program_hash_from_info(data.info);
+      } catch (const std::exception &) {
+        is_valid = false;
+      }
+    }
+
+    // Only instantiate the program binary if the entry is valid; otherwise, the program is left 
+    // uninitialized and rebuilt on first use
+    if (is_valid && !data.binary.empty()) {
+      std::istringstream program_str(std::move(data.binary), std::ios::binary);
+      io::from_stream(data.program, program_str);
+    }
+    data.binary.clear();
+
+    // Move entry from file index into data cache
+    auto it = m_data_cache.emplace(key, std::move(data)).first;
+    m_file_keys.erase(f->second.key);
+    m_file_index.erase(f);
+    monitor(it->first, it->second);
+    return it;
+  }
+
+  void ProgramCache::prefetch() {
+    gl_trace();
+    auto keys = m_file_keys | vws::keys | view_to<std::vector<std::string>>();
+    fetch(keys);
+  }
+
+  std::optional<ProgramCache::IndexFileData> ProgramCache::read_index(std::span<const std::byte> data) {
+    gl_trace();
+    using namespace detail;
+    
+    // Test header and footer; the footer's magic guards against truncated files
+    guard(data.size() >= program_cache_header_size + program_cache_footer_size, { });
+    uint32_t head_magic, head_version, foot_magic;
+    uint64_t index_offset;
+    auto footer = data.last(program_cache_footer_size);
+    std::memcpy(&head_magic,   data.data(), sizeof(uint32_t));
+    std::memcpy(&head_version, data.data() + sizeof(uint32_t), sizeof(uint32_t));
+    std::memcpy(&index_offset, footer.data(), sizeof(uint64_t));
+    std::memcpy(&foot_magic,   footer.data() + sizeof(uint64_t), sizeof(uint32_t));
+    guard(head_magic == program_cache_magic && foot_magic == program_cache_magic, { });
+    guard(head_version == program_cache_version, { });
+    guard(index_offset <= data.size() - program_cache_footer_size, { });
+
+    // Deserialize uncompressed driver identity and index directly from mapped data; a corrupt
+    // index may hold garbage lengths, so failed reads reject the file
+    auto index_data = cast_span<const char>(data.subspan(index_offset, data.size() - program_cache_footer_size - index_offset));
+    std::ispanstream str(index_data);
+    IndexFileData file = { .offset = index_offset };
+    try {
+      io::from_stream(file.driver_id,      str);
+      io::from_stream(file.binary_formats, str);
+      io::from_stream(file.index,          str);
+    } catch (const std::exception &) {
+      return { };
+    }
+    guard(!str.fail(), { });
+
+    // Entries must lie between header and index
+    bool is_bounded = rng::all_of(file.index, [&](const auto &pair) {
+      const auto &index = pair.second;
+      return index.offset >= program_cache_header_size 
+          && index.offset <= index_offset 
+          && index.size   <= index_offset - index.offset;
+    });
+    guard(is_bounded, { });
+    
+    return file;
+  }
+
+  std::vector<ProgramCache::EntryData> ProgramCache::gather(std::function<bool(std::string_view, bool)> pred) const {
+    gl_trace();
+    std::vector<EntryData> entries;
+
+    // Serialize resident entries; this queries program binaries, so it happens on the calling thread
+    std::vector<std::string> raw;
+    for (const auto &[key, data] : m_data_cache) {
+      auto hash_key = program_hash_key(data.hash);
+      guard_continue(pred(hash_key, data.is_dirty));
+      std::ostringstream str(std::ios::binary);
+      io::to_stream(data, str);
+      raw.push_back(str.str());
+      entries.push_back({ .key = hash_key, .index = { .key = key } });
+    }
+
+    // Entries are tagged with the identity of the driver that produced their binaries
+    auto driver_id   = get_driver_id();
+    auto driver_hash = io::hash_bytes(std::as_bytes(std::span(driver_id)));
+
+    // Compress serialized entries in parallel, as independent frames; exceptions cannot leave
+    // the parallel region, so they are caught per entry, and the first is rethrown after
+    std::vector<std::exception_ptr> errors(raw.size());
+    #pragma omp parallel for
+    for (int i = 0; i < static_cast<int>(raw.size()); ++i) {
+      try {
+        auto codec = detail::program_cache_codec;
+        auto &entry = entries[i];
+        entry.data  = detail::compress_cache_entry(raw[i], codec);
+        entry.index = { .key         = std::move(entry.index.key),
+                        .size        = entry.data.size(), 
+                        .size_raw    = raw[i].size(), 
+                        .codec       = static_cast<uint32_t>(codec),
+                        .driver_hash = driver_hash };
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+    }
+    for (const auto &error : errors)
+      if (error)
+        std::rethrow_exception(error);
+
+    // Copy entries not yet fetched from the mapped file as-is, without decompressing; entries
+    // of resident programs are superseded
+    for (const auto &[key, index] : m_file_index) {
+      guard_continue(!m_data_cache.contains(index.key) && pred(key, false));
+      auto data = detail::cache_entry_data(m_file.data(), index.offset, index.size);
+      entries.push_back({ .key = key, .index = index, .data = { range_iter(data) } });
+    }
+
+    return entries;
+  }
+
+  void ProgramCache::write(std::ostream &str, uint64_t offset, detail::string_map<IndexData> index, std::span<const EntryData> entries) {
+    gl_trace();
+
+    // Write compressed entries, and register them in the index; existing entries with the same
+    // content hash, or older contents of the same program, are superseded
+    for (const auto &entry : entries) {
+      auto entry_index = entry.index;
+      entry_index.offset = offset;
+      str.write(reinterpret_cast<const char *>(entry.data.data()), entry.data.size());
+      offset += entry.data.size();
+      std::erase_if(index, [&](const auto &pair) { return pair.second.key == entry_index.key; });
+      index.insert_or_assign(entry.key, entry_index);
+    }
+
+    // Write identity of the writing driver and uncompressed index, followed by footer; as this
+    // block is rewritten on every append, the identity is always that of the last writer
+    uint64_t index_offset = offset;
+    io::to_stream(get_driver_id(),                      str);
+    io::to_stream(detail::get_program_binary_formats(), str);
+    io::to_stream(index,                                str);
+    io::to_stream(index_offset,                         str);
+    io::to_stream(detail::program_cache_magic,          str);
+  }
+
+  void ProgramCache::open(fs::path cache_file_path) {
+    gl_trace();
+
+    m_file_index.clear();
+    m_file_keys.clear();
+    m_file      = detail::MappedFile(cache_file_path);
+    m_file_path = cache_file_path;
+
+    // Read index of mapped file; incompatible files are ignored, and overwritten on next save
+    auto index = read_index(m_file.data());
+    if (!index) {
+      m_file      = { };
+      m_file_path.clear();
+      debug::insert_message(
+        fmt::format("Program cache ignored; incompatible cache at: {}", cache_file_path.string()), 
+        gl::DebugMessageSeverity::eLow);
+      return;
+    }
+
+    // Keep index of entries that are not yet resident, and map their program keys to content hashes
+    for (auto &[key, data] : index->index) {
+      guard_continue(!m_data_cache.contains(data.key));
+      m_file_keys.insert_or_assign(data.key, key);
+      m_file_index.emplace(key, data);
+    }
+
+    // Entries of a different driver are recompiled on first use, and written back on the next
+    // save(...) or append(...); other entries remain valid
+    auto driver_id   = get_driver_id();
+    auto driver_hash = io::hash_bytes(std::as_bytes(std::span(driver_id)));
+    auto n_invalid   = rng::count_if(m_file_index, [driver_hash](const auto &pair) { 
+      return pair.second.driver_hash != driver_hash; 
+    });
+    if (index->driver_id != driver_id || n_invalid > 0) {
+      debug::insert_message(
+        fmt::format("Program cache written by different driver \"{}\"; {} of {} entries will be recompiled on use", 
+                    index->driver_id, n_invalid, m_file_index.size()), 
+        gl::DebugMessageSeverity::eLow);
+    }
+  }
+
+  void ProgramCache::save(fs::path cache_file_path) {
+    gl_trace();
+
+    // Gather all entries before unmapping, as the target may be the mapped file
+    auto entries = gather([](std::string_view, bool) { return true; });
+    m_file_index.clear();
+    m_file_keys.clear();
+    m_file = { };
+
+    // Write header, entries, index, and footer
+    {
+      constexpr auto str_flags = std::ios::out | std::ios::binary | std::ios::trunc;
+      std::ofstream str(cache_file_path, str_flags);
+      debug::check_expr(str.good());
+      io::to_stream(detail::program_cache_magic,   str);
+      io::to_stream(detail::program_cache_version, str);
+      write(str, detail::program_cache_header_size, { }, entries);
+    }
+
+    // Remap saved file; all resident entries are now clean
+    open(cache_file_path);
+    for (auto &[key, data] : m_data_cache)
+      data.is_dirty = false;
 
     // Output OpenGL debug message to warn of cache save
     debug::insert_message(
@@ -730,23 +1775,81 @@ namespace gl {
       gl::DebugMessageSeverity::eLow);
   }
 
+  void ProgramCache::append(fs::path cache_file_path) {
+    gl_trace();
+
+    // Read index of existing cache file
+    std::optional<IndexFileData> target;
+    if (fs::exists(cache_file_path)) {
+      if (m_file.is_open() && fs::equivalent(cache_file_path, m_file_path))
+        target = read_index(m_file.data());
+      else
+        target = read_index(detail::MappedFile(cache_file_path).data());
+    }
+
+    // Fall back to a full save if there is no compatible cache file
+    if (!target) {
+      save(cache_file_path);
+      return;
+    }
+    auto &index        = target->index;
+    auto  index_offset = target->offset;
+
+    // Gather entries that were added or rebuilt, or which are missing from the target file
+    auto entries = gather([&index](std::string_view key, bool is_dirty) { 
+      return is_dirty || !index.contains(key); 
+    });
+    
+    // Write new entries over the old index, followed by the extended index; existing entries are untouched
+    if (!entries.empty()) {
+      m_file_index.clear();
+      m_file_keys.clear();
+      m_file = { };
+      {
+        std::fstream str(cache_file_path, std::ios::in | std::ios::out | std::ios::binary);
+        debug::check_expr(str.good());
+        str.seekp(index_offset);
+        write(str, index_offset, std::move(index), entries);
+      }
+      open(cache_file_path);
+    }
+
+    // All resident entries are now clean
+    for (auto &[key, data] : m_data_cache)
+      data.is_dirty = false;
+
+    // Output OpenGL debug message to warn of cache append
+    debug::insert_message(
+      fmt::format("Program cache appended {} entries to: {}", entries.size(), cache_file_path.string()), 
+      gl::DebugMessageSeverity::eLow);
+  }
+
   void ProgramCache::load(fs::path cache_file_path) {
     gl_trace();
     
     // Sanity check file path
     debug::check_expr(fs::exists(cache_file_path),
       fmt::format("Program cache cannot load; cache does not exist at: {}", cache_file_path.string()));
+    m_time_begin = std::chrono::steady_clock::now();
 
     // Clear out cache first
     *this = { };
 
-    // Next, attempt opening zlib compressed stream, and deserialize to scene object
-    constexpr auto str_flags = std::ios::in  | std::ios::binary;
-    auto str = zstr::ifstream(cache_file_path.string(), str_flags);
-    debug::check_expr(str.good());
-
-    // Deserialize program cache from stream
-    io::from_stream(m_data_cache, str);
+    // Test for indexed format; only the index is read, and entries are fetched on first use.
+    // Files without the magic predate the indexed format, and their layout of shader info has
+    // since changed; these are ignored, and overwritten on the next save
+    uint32_t magic = 0;
+    {
+      std::ifstream str(cache_file_path, std::ios::in | std::ios::binary);
+      io::from_stream(magic, str);
+    }
+    if (magic != detail::program_cache_magic) {
+      debug::insert_message(
+        fmt::format("Program cache ignored; unversioned legacy cache at: {}", cache_file_path.string()), 
+        gl::DebugMessageSeverity::eLow);
+      return;
+    }
+    open(cache_file_path);
 
     // Output OpenGL debug message to warn of cache load
     debug::insert_message(
@@ -756,42 +1859,46 @@ namespace gl {
   
   /* Explicit template instantiations of gl::Program::uniform<...>(...) */
     
-  #define gl_explicit_uniform_template_1(type, short_type)                                         \
+  #define gl_explicit_uniform_template_1(key_type, type, short_type)                               \
     template <> void Program::uniform<type>                                                        \
-    (std::string_view s, const type &v)                                                            \
+    (key_type s, const type &v)                                                                    \
     { glProgramUniform1 ## short_type (m_object, loc(s), v); }
     
-  #define gl_explicit_uniform_template_vector(type, vector_type, short_type)                       \
+  #define gl_explicit_uniform_template_vector(key_type, type, vector_type, short_type)             \
     template <> void Program::uniform<vector_type<type, 2, 1>>                                     \
-      (std::string_view s, const vector_type<type, 2, 1> &v)                                       \
+      (key_type s, const vector_type<type, 2, 1> &v)                                               \
       { glProgramUniform2 ## short_type (m_object, loc(s), v[0], v[1]); }                          \
     template <> void Program::uniform<vector_type<type, 3, 1>>                                     \
-      (std::string_view s, const vector_type<type, 3, 1> &v)                                       \
+      (key_type s, const vector_type<type, 3, 1> &v)                                               \
       { glProgramUniform3 ## short_type (m_object, loc(s), v[0], v[1], v[2]); }                    \
     template <> void Program::uniform<vector_type<type, 4, 1>>                                     \
-      (std::string_view s, const vector_type<type, 4, 1> &v)                                       \
+      (key_type s, const vector_type<type, 4, 1> &v)                                               \
       { glProgramUniform4 ## short_type (m_object, loc(s), v[0], v[1], v[2], v[3]); }
 
-  #define gl_explicit_uniform_template_matrix(type, matrix_type, short_type)                          \
+  #define gl_explicit_uniform_template_matrix(key_type, type, matrix_type, short_type)             \
     template <> void Program::uniform<matrix_type<type, 2, 2>>                                     \
-    (std::string_view s, const matrix_type<type, 2, 2> &v)                                         \
+    (key_type s, const matrix_type<type, 2, 2> &v)                                                 \
     { glProgramUniformMatrix2 ## short_type ## v(m_object, loc(s), 1, false, v.data()); }          \
     template <> void Program::uniform<matrix_type<type, 3, 3>>                                     \
-    (std::string_view s, const matrix_type<type, 3, 3> &v)                                         \
+    (key_type s, const matrix_type<type, 3, 3> &v)                                                 \
     { glProgramUniformMatrix3 ## short_type ## v(m_object, loc(s), 1, false, v.data()); }          \
     template <> void Program::uniform<matrix_type<type, 4, 4>>                                     \
-    (std::string_view s, const matrix_type<type, 4, 4> &v)                                         \
+    (key_type s, const matrix_type<type, 4, 4> &v)                                                 \
     { glProgramUniformMatrix4 ## short_type ## v(m_object, loc(s), 1, false, v.data()); }
 
-  #define gl_explicit_uniform_template(type, short_type)                                           \
-    gl_explicit_uniform_template_1(type, short_type)                                               \
-    gl_explicit_uniform_template_vector(type, eig::Array, short_type)                              \
-    gl_explicit_uniform_template_vector(type, eig::Matrix, short_type)
-
-  gl_explicit_uniform_template(bool, ui)
-  gl_explicit_uniform_template(uint, ui)
-  gl_explicit_uniform_template(int, i)
-  gl_explicit_uniform_template(float, f)
-  gl_explicit_uniform_template_matrix(float, eig::Matrix, f)
-  gl_explicit_uniform_template_matrix(float, eig::Array, f)
+  #define gl_explicit_uniform_template(key_type, type, short_type)                                 \
+    gl_explicit_uniform_template_1(key_type, type, short_type)                                     \
+    gl_explicit_uniform_template_vector(key_type, type, eig::Array, short_type)                    \
+    gl_explicit_uniform_template_vector(key_type, type, eig::Matrix, short_type)
+
+  #define gl_explicit_uniform_templates(key_type)                                                  \
+    gl_explicit_uniform_template(key_type, bool, ui)                                               \
+    gl_explicit_uniform_template(key_type, uint, ui)                                               \
+    gl_explicit_uniform_template(key_type, int, i)                                                 \
+    gl_explicit_uniform_template(key_type, float, f)                                               \
+    gl_explicit_uniform_template_matrix(key_type, float, eig::Matrix, f)                           \
+    gl_explicit_uniform_template_matrix(key_type, float, eig::Array, f)
+
+  gl_explicit_uniform_templates(std::string_view)
+  gl_explicit_uniform_templates(const BindingHandle &)
 } // namespace gl
\ No newline at end of file
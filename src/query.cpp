@@ -0,0 +1,256 @@
+#include <small_gl/query.hpp>
+#include <small_gl/utility.hpp>
+#include <algorithm>
+#include <ranges>
+
+namespace gl {
+  /* Query code */
+
+  Query::Query(QueryInfo info)
+  : Base(true),
+    m_type(info.type),
+    m_is_active(false) {
+    gl_trace_full();
+    glCreateQueries((uint) m_type, 1, &m_object);
+  }
+
+  Query::~Query() {
+    gl_trace_full();
+    guard(m_is_init);
+    glDeleteQueries(1, &m_object);
+  }
+
+  void Query::begin() {
+    gl_trace_full();
+    debug::check_expr(m_is_init, "attempt to use an uninitialized object");
+    debug::check_expr(m_type != QueryType::eTimestamp, "Query::begin() cannot be used for timestamp queries");
+    debug::check_expr(!m_is_active, "attempt to begin an active query");
+
+    m_is_active = true;
+    glBeginQuery((uint) m_type, m_object);
+  }
+
+  void Query::end() {
+    gl_trace_full();
+    debug::check_expr(m_is_init, "attempt to use an uninitialized object");
+    debug::check_expr(m_is_active, "attempt to end an inactive query");
+
+    m_is_active = false;
+    glEndQuery((uint) m_type);
+  }
+
+  void Query::query_counter() {
+    gl_trace_full();
+    debug::check_expr(m_is_init, "attempt to use an uninitialized object");
+    debug::check_expr(m_type == QueryType::eTimestamp, "Query::query_counter() requires a timestamp query");
+    glQueryCounter(m_object, GL_TIMESTAMP);
+  }
+
+  bool Query::is_available() const {
+    gl_trace_full();
+    debug::check_expr(m_is_init, "attempt to use an uninitialized object");
+    GLuint available = GL_FALSE;
+    glGetQueryObjectuiv(m_object, GL_QUERY_RESULT_AVAILABLE, &available);
+    return available != GL_FALSE;
+  }
+
+  uint64_t Query::result() const {
+    gl_trace_full();
+    debug::check_expr(m_is_init, "attempt to use an uninitialized object");
+    GLuint64 value = 0;
+    glGetQueryObjectui64v(m_object, GL_QUERY_RESULT, &value);
+    return value;
+  }
+
+  /* PipelineStatistics code */
+
+  PipelineStatistics & PipelineStatistics::operator+=(const PipelineStatistics &o) {
+    vertices_submitted                 += o.vertices_submitted;
+    primitives_submitted               += o.primitives_submitted;
+    vertex_shader_invocations          += o.vertex_shader_invocations;
+    tess_control_shader_patches        += o.tess_control_shader_patches;
+    tess_evaluation_shader_invocations += o.tess_evaluation_shader_invocations;
+    geometry_shader_invocations        += o.geometry_shader_invocations;
+    geometry_shader_primitives_emitted += o.geometry_shader_primitives_emitted;
+    fragment_shader_invocations        += o.fragment_shader_invocations;
+    compute_shader_invocations         += o.compute_shader_invocations;
+    clipping_input_primitives          += o.clipping_input_primitives;
+    clipping_output_primitives         += o.clipping_output_primitives;
+    time_elapsed                       += o.time_elapsed;
+    n_samples                          += o.n_samples;
+    return *this;
+  }
+
+  /* PipelineQuery code */
+
+  PipelineQuery::PipelineQuery(bool init) {
+    gl_trace_full();
+    guard(init);
+    m_queries.reserve(query_types.size());
+    for (QueryType type : query_types)
+      m_queries.emplace_back(QueryInfo { .type = type });
+  }
+
+  void PipelineQuery::begin() {
+    gl_trace_full();
+    debug::check_expr(is_init(), "attempt to use an uninitialized object");
+    for (auto &query : m_queries)
+      query.begin();
+  }
+
+  void PipelineQuery::end() {
+    gl_trace_full();
+    debug::check_expr(is_init(), "attempt to use an uninitialized object");
+    for (auto &query : m_queries | std::views::reverse)
+      query.end();
+  }
+
+  bool PipelineQuery::is_available() const {
+    gl_trace_full();
+    debug::check_expr(is_init(), "attempt to use an uninitialized object");
+    return std::ranges::all_of(m_queries, [](const Query &q) { return q.is_available(); });
+  }
+
+  PipelineStatistics PipelineQuery::result() const {
+    gl_trace_full();
+    debug::check_expr(is_init(), "attempt to use an uninitialized object");
+
+    // Order matches PipelineQuery::query_types
+    return PipelineStatistics {
+      .vertices_submitted                 = m_queries[0].result(),
+      .primitives_submitted               = m_queries[1].result(),
+      .vertex_shader_invocations          = m_queries[2].result(),
+      .tess_control_shader_patches        = m_queries[3].result(),
+      .tess_evaluation_shader_invocations = m_queries[4].result(),
+      .geometry_shader_invocations        = m_queries[5].result(),
+      .geometry_shader_primitives_emitted = m_queries[6].result(),
+      .fragment_shader_invocations        = m_queries[7].result(),
+      .compute_shader_invocations         = m_queries[8].result(),
+      .clipping_input_primitives          = m_queries[9].result(),
+      .clipping_output_primitives         = m_queries[10].result(),
+      .time_elapsed                       = m_queries[11].result(),
+      .n_samples                          = 1
+    };
+  }
+
+  /* PipelineQueryCache code */
+
+  void PipelineQueryCache::begin(std::string_view key) {
+    gl_trace_full();
+    debug::check_expr(!m_active,
+      fmt::format("PipelineQueryCache::begin(...) called for key \"{}\" while another scope is active", key));
+
+    // Find or insert data for the provided key
+    auto it = m_data_cache.find(key);
+    if (it == m_data_cache.end())
+      it = m_data_cache.emplace(std::string(key), QueryData { }).first;
+    m_active = &it->second;
+
+    // Recycle a resolved query set if one is available, else create a new one
+    if (m_active->free.empty()) {
+      m_active->pending.emplace_back(true);
+    } else {
+      m_active->pending.push_back(std::move(m_active->free.back()));
+      m_active->free.pop_back();
+    }
+
+    m_active->pending.back().begin();
+  }
+
+  void PipelineQueryCache::end() {
+    gl_trace_full();
+    debug::check_expr(m_active, "PipelineQueryCache::end() called without an active scope");
+    m_active->pending.back().end();
+    m_active = nullptr;
+  }
+
+  void PipelineQueryCache::record(std::string_view key, const DrawInfo &info) {
+    gl_trace_full();
+    begin(key);
+    dispatch_draw(info);
+    end();
+  }
+
+  void PipelineQueryCache::record(std::string_view key, const DrawIndirectInfo &info) {
+    gl_trace_full();
+    begin(key);
+    dispatch_draw(info);
+    end();
+  }
+
+  void PipelineQueryCache::record(std::string_view key, const MultiDrawInfo &info) {
+    gl_trace_full();
+    begin(key);
+    dispatch_multidraw(info);
+    end();
+  }
+
+  void PipelineQueryCache::record(std::string_view key, const ComputeInfo &info) {
+    gl_trace_full();
+    begin(key);
+    dispatch_compute(info);
+    end();
+  }
+
+  void PipelineQueryCache::record(std::string_view key, const ComputeIndirectInfo &info) {
+    gl_trace_full();
+    begin(key);
+    dispatch_compute(info);
+    end();
+  }
+
+  void PipelineQueryCache::resolve() {
+    gl_trace_full();
+    for (auto &[key, data] : m_data_cache) {
+      // Query sets resolve in submission order; stop at the first unavailable set
+      while (!data.pending.empty()) {
+        auto &query = data.pending.front();
+        guard_break(!query.is_active() && query.is_available());
+
+        data.last   = query.result();
+        data.total += data.last;
+
+        data.free.push_back(std::move(query));
+        data.pending.pop_front();
+      }
+    }
+  }
+
+  const PipelineStatistics & PipelineQueryCache::at(std::string_view key) const {
+    gl_trace();
+    auto f = m_data_cache.find(key);
+    debug::check_expr(f != m_data_cache.end(),
+      fmt::format("PipelineQueryCache::at(...) failed with key lookup for key: \"{}\"", key));
+    return f->second.total;
+  }
+
+  const PipelineStatistics & PipelineQueryCache::last(std::string_view key) const {
+    gl_trace();
+    auto f = m_data_cache.find(key);
+    debug::check_expr(f != m_data_cache.end(),
+      fmt::format("PipelineQueryCache::last(...) failed with key lookup for key: \"{}\"", key));
+    return f->second.last;
+  }
+
+  std::vector<std::string> PipelineQueryCache::keys() const {
+    gl_trace();
+    std::vector<std::string> keys;
+    keys.reserve(m_data_cache.size());
+    std::ranges::copy(m_data_cache | std::views::keys, std::back_inserter(keys));
+    return keys;
+  }
+
+  void PipelineQueryCache::reset() {
+    gl_trace();
+    for (auto &[key, data] : m_data_cache) {
+      data.last  = { };
+      data.total = { };
+    }
+  }
+
+  void PipelineQueryCache::clear() {
+    gl_trace();
+    debug::check_expr(!m_active, "PipelineQueryCache::clear() called while a scope is active");
+    m_data_cache.clear();
+  }
+} // namespace gl
@@ -0,0 +1,88 @@
+#include <small_gl/detail/skyline_packer.hpp>
+#include <limits>
+
+namespace gl::detail {
+  SkylinePacker::SkylinePacker(eig::Array2u size)
+  : m_size(size) {
+    gl_trace();
+    clear();
+  }
+
+  void SkylinePacker::clear() {
+    gl_trace();
+    m_nodes     = { NodeData { .x = 0, .y = 0, .width = m_size.x() } };
+    m_used_area = 0;
+  }
+
+  bool SkylinePacker::fit(uint i, const eig::Array2u &size, uint &y, size_t &waste) const {
+    gl_trace_full();
+    guard(m_nodes[i].x + size.x() <= m_size.x(), false);
+
+    // Rectangle rests on the highest segment it spans
+    y = 0;
+    for (uint j = i, width_left = size.x(); width_left > 0; ++j) {
+      y = std::max(y, m_nodes[j].y);
+      width_left -= std::min(width_left, m_nodes[j].width);
+    }
+    guard(y + size.y() <= m_size.y(), false);
+
+    // Area between the rectangle's bottom and the segments it spans
+    waste = 0;
+    for (uint j = i, width_left = size.x(); width_left > 0; ++j) {
+      uint w = std::min(width_left, m_nodes[j].width);
+      waste += static_cast<size_t>(y - m_nodes[j].y) * w;
+      width_left -= w;
+    }
+
+    return true;
+  }
+
+  std::optional<eig::Array2u> SkylinePacker::insert(eig::Array2u size) {
+    gl_trace_full();
+    guard((size > 0u).all(), std::nullopt);
+
+    // Find bottom-left position, ties broken by least waste
+    uint   best_i = std::numeric_limits<uint>::max(), best_y = std::numeric_limits<uint>::max();
+    size_t best_waste = std::numeric_limits<size_t>::max();
+    for (uint i = 0; i < m_nodes.size(); ++i) {
+      uint   y;
+      size_t waste;
+      guard_continue(fit(i, size, y, waste));
+      if (y < best_y || (y == best_y && waste < best_waste)) {
+        best_i     = i;
+        best_y     = y;
+        best_waste = waste;
+      }
+    }
+    guard(best_i != std::numeric_limits<uint>::max(), std::nullopt);
+
+    // Insert new segment on top of the rectangle, and shrink or remove segments it covers
+    NodeData node = { .x = m_nodes[best_i].x, .y = best_y + size.y(), .width = size.x() };
+    m_nodes.insert(m_nodes.begin() + best_i, node);
+    for (uint i = best_i + 1; i < m_nodes.size();) {
+      auto &prev = m_nodes[i - 1], &curr = m_nodes[i];
+      guard_break(curr.x < prev.x + prev.width);
+      uint shrink = prev.x + prev.width - curr.x;
+      if (curr.width <= shrink) {
+        m_nodes.erase(m_nodes.begin() + i);
+      } else {
+        curr.x     += shrink;
+        curr.width -= shrink;
+        break;
+      }
+    }
+
+    // Merge neighbouring segments of equal height
+    for (uint i = 0; i + 1 < m_nodes.size();) {
+      if (m_nodes[i].y == m_nodes[i + 1].y) {
+        m_nodes[i].width += m_nodes[i + 1].width;
+        m_nodes.erase(m_nodes.begin() + i + 1);
+      } else {
+        ++i;
+      }
+    }
+
+    m_used_area += static_cast<size_t>(size.prod());
+    return eig::Array2u(node.x, best_y);
+  }
+} // namespace gl::detail
@@ -1,17 +1,27 @@
 #include <small_gl/texture.hpp>
 #include <small_gl/buffer.hpp>
+#include <algorithm>
+#include <array>
 
 namespace gl {
   /* Texture section */
 
   template <typename T, uint D, uint C, TextureType Ty>
   Texture<T, D, C, Ty>::Texture(InfoType info)
-  : Base(true), m_size(info.size), m_levels(info.levels) {
+  : Base(true), m_size(info.size), m_levels(info.levels), m_is_sparse(info.is_sparse) {
     gl_trace_full();
     debug::check_expr((m_size >= vect(1)).all(), "texture size must be all >= 1");
     debug::check_expr(m_levels >= 1,  "texture level must be >= 1");
+    debug::check_expr(!m_is_sparse || GLAD_GL_ARB_sparse_texture, 
+      "sparse texture requested, but ARB_sparse_texture is not supported");
+    debug::check_expr(!m_is_sparse || !info.data.data(), 
+      "sparse texture cannot be created with initial data");
 
     glCreateTextures(detail::texture_target<D, Ty>(), 1, &m_object);
+
+    // Sparse textures only allocate virtual storage; must be flagged before storage is specified
+    if (m_is_sparse)
+      glTextureParameteri(m_object, GL_TEXTURE_SPARSE_ARB, GL_TRUE);
   
     constexpr auto internal_format = detail::texture_internal_format<C, T>();
     constexpr auto storage_type = detail::texture_storage_type<D, Ty>();
@@ -127,7 +137,7 @@ namespace gl {
   }
 
   template <typename T, uint D, uint C, TextureType Ty>
-  void Texture<T, D, C, Ty>::set(const gl::Buffer &data, uint level, vect size, vect offset)
+  void Texture<T, D, C, Ty>::set(const gl::Buffer &data, uint level, vect size, vect offset, size_t data_offset)
   requires(!detail::is_cubemap_type<Ty>) {
     gl_trace_full();
 
@@ -139,29 +149,30 @@ namespace gl {
     const vect   safe_size  = size.isZero() ? m_size : size;
     const size_t size_bytes = safe_size.prod() * C * pixel_size;
 
-    debug::check_expr(data.is_init() && data.size() >= size_bytes,
+    debug::check_expr(data.is_init() && data.size() >= data_offset + size_bytes,
       "provided data buffer is too small for requested texture region to be read");
 
-    // Bind buffer for pixel unpack operation
+    // Bind buffer for pixel unpack operation; data pointer is interpreted as buffer offset
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, data.object());
+    const void *data_ptr = reinterpret_cast<const void *>(data_offset);
 
     if constexpr (storage_type == detail::StorageType::e1D) {
       glTextureSubImage1D(m_object, level, 
         offset.x(), 
         safe_size.x(), 
-        format, pixel_format, nullptr);
+        format, pixel_format, data_ptr);
     } else if constexpr (storage_type == detail::StorageType::e2D
                       || storage_type == detail::StorageType::e2DMSAA) {
       glTextureSubImage2D(m_object, level, 
         offset.x(), offset.y(), 
         safe_size.x(), safe_size.y(), 
-        format, pixel_format, nullptr);              
+        format, pixel_format, data_ptr);              
     } else if constexpr (storage_type == detail::StorageType::e3D
                       || storage_type == detail::StorageType::e3DMSAA) {
       glTextureSubImage3D(m_object, level, 
         offset.x(), offset.y(), offset.z(),
         safe_size.x(), safe_size.y(), safe_size.z(),
-        format, pixel_format, nullptr);
+        format, pixel_format, data_ptr);
     }
 
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER,0);
@@ -329,6 +340,62 @@ namespace gl {
     }
   }
   
+  template <typename T, uint D, uint C, TextureType Ty>
+  Texture<T, D, C, Ty>::vect Texture<T, D, C, Ty>::page_size() const {
+    gl_trace_full();
+    
+    std::array<int, 3> page = { 1, 1, 1 };
+    glGetInternalformativ(target(), internal_format(), GL_VIRTUAL_PAGE_SIZE_X_ARB, 1, &page[0]);
+    glGetInternalformativ(target(), internal_format(), GL_VIRTUAL_PAGE_SIZE_Y_ARB, 1, &page[1]);
+    glGetInternalformativ(target(), internal_format(), GL_VIRTUAL_PAGE_SIZE_Z_ARB, 1, &page[2]);
+
+    // Array layers are committed individually
+    vect v;
+    for (uint i = 0; i < v.size(); ++i)
+      v[i] = (Ty == TextureType::eImageArray && i == D) ? 1u : static_cast<uint>(page[i]);
+    return v;
+  }
+
+  template <typename T, uint D, uint C, TextureType Ty>
+  uint Texture<T, D, C, Ty>::sparse_levels() const {
+    gl_trace_full();
+    guard(m_is_sparse, m_levels);
+    int levels = 0;
+    glGetTextureParameteriv(m_object, GL_NUM_SPARSE_LEVELS_ARB, &levels);
+    return static_cast<uint>(levels);
+  }
+
+  template <typename T, uint D, uint C, TextureType Ty>
+  void Texture<T, D, C, Ty>::commit(bool commit, uint level, vect size, vect offset)
+  requires(!detail::is_cubemap_type<Ty>) {
+    gl_trace_full();
+    debug::check_expr(m_is_sparse, "attempt to commit pages of a non-sparse texture");
+
+    // Default to the full level; array layers do not shrink with level
+    if (size.isZero()) {
+      size = m_size;
+      for (uint i = 0; i < (Ty == TextureType::eImageArray ? D : static_cast<uint>(size.size())); ++i)
+        size[i] = std::max(1u, m_size[i] >> level);
+    }
+
+    eig::Array3u offs_safe = 0, size_safe = 1;
+    offs_safe.head<vect::RowsAtCompileTime>() = offset;
+    size_safe.head<vect::RowsAtCompileTime>() = size;
+
+    // Prefer direct state access; ARB_sparse_texture itself only exposes the bind-based entry point
+    if (GLAD_GL_EXT_direct_state_access) {
+      glTexturePageCommitmentEXT(m_object, level, 
+        offs_safe.x(), offs_safe.y(), offs_safe.z(),
+        size_safe.x(), size_safe.y(), size_safe.z(), commit);
+    } else {
+      glBindTexture(target(), m_object);
+      glTexPageCommitmentARB(target(), level, 
+        offs_safe.x(), offs_safe.y(), offs_safe.z(),
+        size_safe.x(), size_safe.y(), size_safe.z(), commit);
+      glBindTexture(target(), 0);
+    }
+  }
+
   template <typename T, uint D, uint C, TextureType Ty>
   void Texture<T, D, C, Ty>::generate_mipmaps() {
     gl_trace_full();
@@ -0,0 +1,225 @@
+#include <small_gl/texture_atlas.hpp>
+#include <algorithm>
+#include <bit>
+#include <numeric>
+
+namespace gl {
+  template <typename T, uint C>
+  TextureAtlas<T, C>::TextureAtlas(TextureAtlasInfo info)
+  : m_info(info) {
+    gl_trace();
+    debug::check_expr((info.size > 0u).all() && info.layers > 0,
+      "TextureAtlas requires a non-empty layer size and at least one layer");
+
+    m_packers.resize(info.layers, detail::SkylinePacker(info.size));
+    m_layer_count.resize(info.layers, 0);
+    m_texture = {{ .size = { info.size.x(), info.size.y(), info.layers }, .levels = 1 }};
+    m_texture.clear();
+  }
+
+  template <typename T, uint C>
+  float TextureAtlas<T, C>::occupancy() const {
+    gl_trace();
+    guard(!m_packers.empty(), 0.f);
+    size_t used = std::transform_reduce(range_iter(m_packers), size_t(0), std::plus<>(), 
+      [](const auto &p) { return p.used_area(); });
+    return static_cast<float>(used) / static_cast<float>(m_packers.size() * m_info.size.prod());
+  }
+
+  template <typename T, uint C>
+  void TextureAtlas<T, C>::resize(uint layers) {
+    gl_trace();
+    
+    TextureArrayType texture = {{ .size = { m_info.size.x(), m_info.size.y(), layers }, .levels = 1 }};
+    texture.clear();
+
+    // Copy contents of layers that remain
+    uint n_copy = std::min(layers, static_cast<uint>(m_packers.size()));
+    if (n_copy > 0)
+      m_texture.copy_to(texture, 0, { m_info.size.x(), m_info.size.y(), n_copy });
+    
+    m_texture = std::move(texture);
+    m_packers.resize(layers, detail::SkylinePacker(m_info.size));
+    m_layer_count.resize(layers, 0);
+  }
+
+  template <typename T, uint C>
+  std::pair<uint, eig::Array2u> TextureAtlas<T, C>::place(const eig::Array2u &padded_size) {
+    gl_trace();
+    // Oversize allocations never fit, not even in a new layer; fail regardless of debug checks
+    if ((padded_size > m_info.size).any()) {
+      detail::Exception e;
+      e.put("src", "gl::TextureAtlas::insert(...)");
+      e.put("message", "allocation exceeds layer size");
+      throw e;
+    }
+
+    for (uint layer = 0; layer < m_packers.size(); ++layer)
+      if (auto offset = m_packers[layer].insert(padded_size))
+        return { layer, *offset };
+
+    // No layer has space; double the nr. of layers, and place in the first new layer
+    uint layer = static_cast<uint>(m_packers.size());
+    resize(std::max(1u, layer * 2));
+    return { layer, *m_packers[layer].insert(padded_size) };
+  }
+
+  template <typename T, uint C>
+  void TextureAtlas<T, C>::update_rect(uint id) {
+    gl_trace();
+    const auto &alloc = m_allocs[id];
+    auto       &rect  = m_rects[id];
+    if (alloc.is_used) {
+      eig::Array2f scale = m_info.size.cast<float>().inverse();
+      eig::Array2u end   = alloc.offset + alloc.size;
+      rect.uv.template head<2>() = alloc.offset.template cast<float>() * scale;
+      rect.uv.template tail<2>() = end.cast<float>() * scale;
+      rect.layer = alloc.layer;
+    } else {
+      rect = { };
+    }
+    m_is_dirty = true;
+  }
+
+  template <typename T, uint C>
+  const gl::Buffer &TextureAtlas<T, C>::buffer() {
+    gl_trace();
+    guard(m_is_dirty || !m_buffer.is_init(), m_buffer);
+
+    auto data = std::as_bytes(std::span(m_rects));
+    if (!m_buffer.is_init() || m_buffer.size() < data.size()) {
+      // Grow to the next power of two in records, to amortize reallocation
+      size_t capacity = std::bit_ceil(std::max<size_t>(m_rects.size(), 64)) * sizeof(RectData);
+      m_buffer = {{ .size = capacity, .flags = BufferCreateFlags::eStorageDynamic }};
+    }
+    if (!data.empty())
+      m_buffer.set(data, data.size());
+
+    m_is_dirty = false;
+    return m_buffer;
+  }
+
+  template <typename T, uint C>
+  uint TextureAtlas<T, C>::insert(eig::Array2u size, std::span<const T> data) {
+    gl_trace();
+    debug::check_expr(is_init(), "attempt to use an uninitialized object");
+    debug::check_expr(data.size() >= static_cast<size_t>(size.prod()) * C,
+      "TextureAtlas::insert(...) provided data span is too small for requested size");
+
+    eig::Array2u padded_size = size + 2 * m_info.padding;
+    auto [layer, offset] = place(padded_size);
+    
+    // Obtain id, reusing freed ids first
+    uint id;
+    if (!m_free_ids.empty()) {
+      id = m_free_ids.back();
+      m_free_ids.pop_back();
+    } else {
+      id = static_cast<uint>(m_allocs.size());
+      m_allocs.emplace_back();
+      m_rects.emplace_back();
+    }
+
+    auto &alloc = m_allocs[id];
+    alloc = { .offset = offset + m_info.padding, .size = size, .layer = layer, .is_used = true };
+    m_layer_count[layer]++;
+    
+    // Clear the padding border, as texels of erased allocations may remain once a layer's
+    // packer is reset, and would bleed into filtered lookups
+    if (m_info.padding > 0)
+      m_texture.clear({ }, 0, { padded_size.x(), padded_size.y(), 1 }, { offset.x(), offset.y(), layer });
+
+    // Unpack tightly, as rows of arbitrary widths need not be 4-byte aligned
+    detail::with_unpack_alignment_1([&] {
+      m_texture.set(data, 0, { size.x(), size.y(), 1 }, { alloc.offset.x(), alloc.offset.y(), layer });
+    });
+    update_rect(id);
+    return id;
+  }
+
+  template <typename T, uint C>
+  void TextureAtlas<T, C>::erase(uint id) {
+    gl_trace();
+    debug::check_expr(id < m_allocs.size() && m_allocs[id].is_used,
+      fmt::format("TextureAtlas::erase(...) failed; id {} is not in use", id));
+
+    auto &alloc = m_allocs[id];
+    if (--m_layer_count[alloc.layer] == 0)
+      m_packers[alloc.layer].clear();
+    alloc = { };
+    m_free_ids.push_back(id);
+    update_rect(id);
+  }
+
+  template <typename T, uint C>
+  void TextureAtlas<T, C>::defragment() {
+    gl_trace();
+    debug::check_expr(is_init(), "attempt to use an uninitialized object");
+
+    // Repack live allocations on the CPU, tallest first, which packs skylines more tightly
+    std::vector<uint> ids;
+    for (uint id = 0; id < m_allocs.size(); ++id)
+      if (m_allocs[id].is_used)
+        ids.push_back(id);
+    std::ranges::sort(ids, [&](uint a, uint b) {
+      const auto &sa = m_allocs[a].size, &sb = m_allocs[b].size;
+      return sa.y() != sb.y() ? sa.y() > sb.y() : sa.x() > sb.x();
+    });
+
+    std::vector<detail::SkylinePacker> packers;
+    std::vector<uint>                  layer_count;
+    std::vector<AllocData>             allocs = m_allocs;
+    for (uint id : ids) {
+      auto &alloc  = allocs[id];
+      auto  padded = alloc.size + 2 * m_info.padding;
+      for (uint layer = 0;; ++layer) {
+        if (layer == packers.size()) {
+          packers.emplace_back(m_info.size);
+          layer_count.push_back(0);
+        }
+        if (auto offset = packers[layer].insert(padded)) {
+          alloc.offset = *offset + m_info.padding;
+          alloc.layer  = layer;
+          layer_count[layer]++;
+          break;
+        }
+      }
+    }
+    if (packers.empty()) {
+      packers.emplace_back(m_info.size);
+      layer_count.push_back(0);
+    }
+
+    // Copy allocations to their new positions in a new array
+    uint layers = static_cast<uint>(packers.size());
+    TextureArrayType texture = {{ .size = { m_info.size.x(), m_info.size.y(), layers }, .levels = 1 }};
+    texture.clear();
+    for (uint id : ids) {
+      const auto &src = m_allocs[id], &dst = allocs[id];
+      m_texture.copy_to(texture, 0, 
+        { src.size.x(),   src.size.y(),   1 }, 
+        { src.offset.x(), src.offset.y(), src.layer }, 
+        { dst.offset.x(), dst.offset.y(), dst.layer });
+    }
+
+    m_texture     = std::move(texture);
+    m_packers     = std::move(packers);
+    m_layer_count = std::move(layer_count);
+    m_allocs      = std::move(allocs);
+    for (uint id : ids)
+      update_rect(id);
+  }
+
+  /* Explicit template instantiations of gl::TextureAtlas<...> */
+
+  #define gl_explicit_texture_atlas_components_1234(type)\
+    template class TextureAtlas<type, 1>;\
+    template class TextureAtlas<type, 2>;\
+    template class TextureAtlas<type, 3>;\
+    template class TextureAtlas<type, 4>;
+  gl_explicit_texture_atlas_components_1234(ushort)
+  gl_explicit_texture_atlas_components_1234(short)
+  gl_explicit_texture_atlas_components_1234(uint)
+  gl_explicit_texture_atlas_components_1234(int)
+  gl_explicit_texture_atlas_components_1234(float)
+} // namespace gl
@@ -0,0 +1,107 @@
+#include <small_gl/texture_pool.hpp>
+#include <algorithm>
+
+namespace gl {
+  TexturePool::TexturePool(TexturePoolInfo info)
+  : m_info(info) {
+    gl_trace();
+    debug::check_expr(info.size_bucket > 0, "TexturePool requires a non-zero size bucket");
+  }
+
+  eig::Array3u TexturePool::bucket(const eig::Array3u &size, uint dims) const {
+    guard(m_is_resizing, size);
+    eig::Array3u bucketed = size;
+    for (uint i = 0; i < dims; ++i)
+      bucketed[i] = (size[i] + m_info.size_bucket - 1) / m_info.size_bucket * m_info.size_bucket;
+    return bucketed;
+  }
+
+  AbstractFramebufferAttachment *TexturePool::find(std::type_index type, const eig::Array4u &key) {
+    gl_trace();
+    auto it = std::find_if(range_iter(m_objects), [&](const ObjectData &o) {
+      return !o.is_used && o.type == type && (o.key == key).all();
+    });
+    guard(it != m_objects.end(), nullptr);
+    it->is_used   = true;
+    it->last_used = m_frame;
+    return it->object.get();
+  }
+
+  void TexturePool::insert(std::type_index type, const eig::Array4u &key, std::unique_ptr<AbstractFramebufferAttachment> object) {
+    gl_trace();
+    m_objects.push_back({ .type      = type, 
+                          .key       = key, 
+                          .object    = std::move(object), 
+                          .last_used = m_frame, 
+                          .is_used   = true });
+  }
+
+  gl::Framebuffer &TexturePool::framebuffer(std::initializer_list<FramebufferAttachmentInfo> info) {
+    gl_trace();
+
+    std::vector<AttachmentData> attachments;
+    attachments.reserve(info.size());
+    for (const auto &i : info) {
+      debug::check_expr(i.attachment && i.attachment->is_init(), "attempt to use an uninitialized object");
+      attachments.push_back({ .type   = i.type, 
+                              .index  = i.index,
+                              .object = i.attachment->object(), 
+                              .layer  = i.layer, 
+                              .level  = i.level });
+    }
+
+    // Return cached framebuffer over the same attachments, if it exists
+    auto it = std::find_if(range_iter(m_framebuffers), [&](const FramebufferData &f) {
+      return f.attachments == attachments;
+    });
+    if (it != m_framebuffers.end()) {
+      it->last_used = m_frame;
+      return *it->framebuffer;
+    }
+
+    m_framebuffers.push_back({ .attachments = std::move(attachments),
+                               .framebuffer = std::make_unique<gl::Framebuffer>(info),
+                               .last_used   = m_frame });
+    return *m_framebuffers.back().framebuffer;
+  }
+
+  void TexturePool::mark_resize() {
+    gl_trace();
+    m_resize_frame = m_frame;
+    m_is_resizing  = true;
+  }
+
+  void TexturePool::end_frame() {
+    gl_trace();
+
+    // Destroy idle objects, and any cached framebuffers that reference them
+    std::erase_if(m_objects, [&](const ObjectData &o) {
+      guard(m_frame - o.last_used >= m_info.max_idle_frames, false);
+      std::erase_if(m_framebuffers, [&](const FramebufferData &f) {
+        return std::ranges::any_of(f.attachments, [&](const AttachmentData &a) { 
+          return a.object == o.object->object(); 
+        });
+      });
+      return true;
+    });
+
+    // Destroy idle framebuffers
+    std::erase_if(m_framebuffers, [&](const FramebufferData &f) {
+      return m_frame - f.last_used >= m_info.max_idle_frames;
+    });
+
+    // Release remaining objects for reuse
+    for (auto &o : m_objects)
+      o.is_used = false;
+
+    m_frame++;
+    if (m_is_resizing && m_frame - m_resize_frame > m_info.resize_frames)
+      m_is_resizing = false;
+  }
+
+  void TexturePool::clear() {
+    gl_trace();
+    m_framebuffers.clear();
+    m_objects.clear();
+  }
+} // namespace gl
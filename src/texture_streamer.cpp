@@ -0,0 +1,94 @@
+#include <small_gl/texture_streamer.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace gl {
+  namespace detail {
+    // Alignment of staged regions inside the ring; covers any texel size
+    constexpr size_t texture_streamer_alignment = 256;
+
+    // Chunk size for parallel copies into the ring
+    constexpr size_t texture_streamer_chunk_size = 1024 * 1024;
+  } // namespace detail
+
+  TextureStreamer::TextureStreamer(TextureStreamerInfo info)
+  : m_info(info) {
+    gl_trace();
+    debug::check_expr(info.size > 0, "TextureStreamer requires a non-empty ring");
+
+    m_buffer  = {{ .size = info.size, .flags = BufferCreateFlags::eMapWritePersistent }};
+    m_mapping = m_buffer.map(BufferAccessFlags::eMapWritePersistent | BufferAccessFlags::eMapFlush);
+  }
+
+  TextureStreamer::~TextureStreamer() {
+    gl_trace();
+    // Regions in flight are released with the buffer; GL defers deletion until unpacks complete
+  }
+
+  void TextureStreamer::poll() {
+    gl_trace_full();
+    while (!m_regions.empty() && m_regions.front().fence.is_signalled())
+      m_regions.pop_front();
+  }
+
+  std::optional<size_t> TextureStreamer::place(size_t size) const {
+    // Place region after the previous one, wrapping around if it does not fit at the end
+    size_t offset = (m_head + detail::texture_streamer_alignment - 1) 
+                  & ~(detail::texture_streamer_alignment - 1);
+    if (offset + size > m_info.size)
+      offset = 0;
+
+    // Region may not overlap regions still in flight
+    bool is_overlapping = std::any_of(range_iter(m_regions), [&](const RegionData &r) {
+      return offset < r.offset + r.size && r.offset < offset + size;
+    });
+    guard(!is_overlapping, std::nullopt);
+    return offset;
+  }
+
+  bool TextureStreamer::can_stage(size_t size) {
+    gl_trace_full();
+    guard(is_init() && size <= m_info.size, false);
+    poll();
+    return place(size).has_value();
+  }
+
+  std::optional<size_t> TextureStreamer::stage(std::span<const std::byte> data) {
+    gl_trace_full();
+    debug::check_expr(is_init(), "attempt to use an uninitialized object");
+    if (data.size() > m_info.size)
+      debug::check_expr(false,
+        fmt::format("TextureStreamer::set(...) failed; upload of {} bytes exceeds ring size", data.size()));
+    
+    poll();
+    size_t size = data.size();
+    auto placed = place(size);
+    guard(placed, std::nullopt);
+    size_t offset = *placed;
+
+    // Copy data into the ring, on multiple threads for large uploads
+    auto dst = m_mapping.subspan(offset, size);
+    if (m_info.parallel_copy_size > 0 && size >= m_info.parallel_copy_size) {
+      int n_chunks = static_cast<int>((size + detail::texture_streamer_chunk_size - 1) / detail::texture_streamer_chunk_size);
+      #pragma omp parallel for
+      for (int i = 0; i < n_chunks; ++i) {
+        size_t chunk_offset = i * detail::texture_streamer_chunk_size;
+        size_t chunk_size   = std::min(detail::texture_streamer_chunk_size, size - chunk_offset);
+        std::memcpy(dst.data() + chunk_offset, data.data() + chunk_offset, chunk_size);
+      }
+    } else {
+      std::memcpy(dst.data(), data.data(), size);
+    }
+    m_buffer.flush(size, offset);
+
+    m_head = offset + size;
+    return offset;
+  }
+
+  void TextureStreamer::submit(size_t offset, size_t size) {
+    gl_trace_full();
+    m_regions.push_back({ .offset = offset, 
+                          .size   = size, 
+                          .fence  = sync::Fence(sync::time_ns(0)) });
+  }
+} // namespace gl
@@ -0,0 +1,98 @@
+#include <small_gl/program.hpp>
+#include <small_gl/uniform_block.hpp>
+#include <small_gl/utility.hpp>
+#include <small_gl/detail/trace.hpp>
+#include <array>
+
+namespace gl {
+  UniformBlock::UniformBlock(UniformBlockInfo info) {
+    gl_trace_full();
+    debug::check_expr(info.program && info.program->is_init(),
+      "UniformBlock requires an initialized program object");
+    debug::check_expr(!info.program->is_pending(),
+      "UniformBlock requires a program with resolved compilation");
+
+    GLuint program = info.program->object();
+
+    // Find uniform block resource
+    GLuint index = glGetProgramResourceIndex(program, GL_UNIFORM_BLOCK, info.name.c_str());
+    debug::check_expr(index != GL_INVALID_INDEX,
+      fmt::format("UniformBlock failed with name lookup for block name: \"{}\"", info.name));
+
+    // Query block size, binding, and nr. of active members
+    constexpr std::array<GLenum, 3> block_props = { GL_BUFFER_DATA_SIZE, GL_BUFFER_BINDING, GL_NUM_ACTIVE_VARIABLES };
+    std::array<GLint, 3> block_values;
+    glGetProgramResourceiv(program, GL_UNIFORM_BLOCK, index,
+      block_props.size(), block_props.data(), block_values.size(), nullptr, block_values.data());
+    auto [block_size, block_binding, n_members] = block_values;
+
+    // Query indices of active members
+    std::vector<GLint> member_indices(n_members);
+    constexpr GLenum member_indices_prop = GL_ACTIVE_VARIABLES;
+    glGetProgramResourceiv(program, GL_UNIFORM_BLOCK, index,
+      1, &member_indices_prop, member_indices.size(), nullptr, member_indices.data());
+
+    // Reflect member names and layout
+    constexpr std::array<GLenum, 5> member_props = { GL_NAME_LENGTH, GL_OFFSET, GL_ARRAY_STRIDE,
+                                                     GL_MATRIX_STRIDE, GL_ARRAY_SIZE };
+    for (GLint member_index : member_indices) {
+      std::array<GLint, 5> member_values;
+      glGetProgramResourceiv(program, GL_UNIFORM, member_index,
+        member_props.size(), member_props.data(), member_values.size(), nullptr, member_values.data());
+      auto [name_length, offset, array_stride, matrix_stride, array_size] = member_values;
+
+      std::string name(name_length, '\0');
+      glGetProgramResourceName(program, GL_UNIFORM, member_index, name.size(), nullptr, name.data());
+      name.resize(name_length - 1); // Strip null terminator
+
+      // Array members are reflected as "name[0]"; strip suffix so arrays are accessed by plain name
+      if (name.ends_with("[0]"))
+        name.resize(name.size() - 3);
+
+      m_members.emplace(std::move(name), MemberData { .offset        = static_cast<size_t>(offset),
+                                                      .array_stride  = static_cast<size_t>(array_stride),
+                                                      .matrix_stride = static_cast<size_t>(matrix_stride),
+                                                      .array_size    = static_cast<uint>(array_size) });
+    }
+
+    // Allocate shadow copy and backing buffer
+    m_binding = static_cast<uint>(block_binding);
+    m_data.resize(block_size, std::byte(0));
+    m_buffer = {{ .size = m_data.size(), .data = m_data, .flags = BufferCreateFlags::eStorageDynamic }};
+  }
+
+  const UniformBlock::MemberData & UniformBlock::lookup(std::string_view s) const {
+    gl_trace();
+    auto f = m_members.find(s);
+    if (f == m_members.end())
+      debug::check_expr(false,
+        fmt::format("UniformBlock::set(...) failed with name lookup for member name: \"{}\"", s));
+    return f->second;
+  }
+
+  bool UniformBlock::contains(std::string_view s) const {
+    gl_trace();
+    return m_members.contains(s);
+  }
+
+  void UniformBlock::commit() {
+    gl_trace_full();
+    debug::check_expr(is_init(), "attempt to use an uninitialized object");
+
+    // Upload modified range in a single buffer update
+    if (is_dirty()) {
+      size_t size = m_dirty_end - m_dirty_begin;
+      m_buffer.set(std::span(m_data).subspan(m_dirty_begin, size), size, m_dirty_begin);
+      m_dirty_begin = std::numeric_limits<size_t>::max();
+      m_dirty_end   = 0;
+    }
+
+    bind();
+  }
+
+  void UniformBlock::bind() const {
+    gl_trace_full();
+    debug::check_expr(is_init(), "attempt to use an uninitialized object");
+    m_buffer.bind_to(BufferTargetType::eUniform, m_binding);
+  }
+} // namespace gl
@@ -2,6 +2,7 @@
 #include <small_gl/buffer.hpp>
 #include <small_gl/utility.hpp>
 #include <nlohmann/json.hpp>
+#include <xxhash.h>
 #include <array>
 #include <fstream>
 #include <ranges>
@@ -104,6 +105,15 @@ namespace gl {
       return VendorType::eOther;
   }
 
+  std::string get_driver_id() {
+    gl_trace_full();
+    auto get_string = [](GLenum name) {
+      const GLubyte *c_str = glGetString(name);
+      return std::string(c_str ? reinterpret_cast<const char *>(c_str) : "");
+    };
+    return fmt::format("{};{};{}", get_string(GL_VENDOR), get_string(GL_RENDERER), get_string(GL_VERSION));
+  }
+
   namespace io {
     std::vector<std::byte> load_binary(const fs::path &path) {
       gl_trace();
@@ -156,6 +166,16 @@ namespace gl {
     json load_json(const fs::path &path) {
       return json::parse(load_string(path));
     }
+
+    uint64_t hash_bytes(std::span<const std::byte> data, uint64_t seed) {
+      gl_trace();
+      return XXH3_64bits_withSeed(data.data(), data.size_bytes(), seed);
+    }
+
+    uint64_t hash_file(const fs::path &path, uint64_t seed) {
+      gl_trace();
+      return hash_bytes(load_binary(path), seed);
+    }
   } // namespace io
 
   namespace sync {
@@ -193,6 +213,14 @@ namespace gl {
       guard(m_is_init);
       glWaitSync((GLsync) m_object, 0, GL_TIMEOUT_IGNORED);
     }
+
+    bool Fence::is_signalled() const {
+      gl_trace_full();
+      guard(m_is_init, true);
+      GLint status = GL_UNSIGNALED;
+      glGetSynciv((GLsync) m_object, GL_SYNC_STATUS, 1, nullptr, &status);
+      return status == GL_SIGNALED;
+    }
   } // namespace sync
 
   namespace state {
@@ -0,0 +1,192 @@
+#include <small_gl/virtual_texture.hpp>
+#include <algorithm>
+#include <iterator>
+
+namespace gl {
+  bool is_sparse_supported() {
+    gl_trace();
+    return GLAD_GL_ARB_sparse_texture;
+  }
+
+  template <typename T, uint C>
+  VirtualTexture<T, C>::VirtualTexture(InfoType info)
+  : m_info(info) {
+    gl_trace();
+    debug::check_expr(is_sparse_supported(), "VirtualTexture requires ARB_sparse_texture");
+    debug::check_expr(static_cast<bool>(info.loader), "VirtualTexture requires a page loader");
+    debug::check_expr(info.levels >= 1, "VirtualTexture requires at least one level");
+
+    m_texture       = {{ .size = info.size, .levels = info.levels, .is_sparse = true }};
+    m_streamer      = TextureStreamer(info.staging);
+    m_page_size     = m_texture.page_size();
+    m_sparse_levels = std::min(m_texture.sparse_levels(), info.levels);
+    debug::check_expr((m_page_size > 0u).all(),
+      "VirtualTexture failed; texture format has no sparse page size");
+    debug::check_expr((info.size - (info.size / m_page_size) * m_page_size).isZero(),
+      "VirtualTexture failed; texture size must be a multiple of the page size");
+
+    // Lay out page grids of sparse levels, level by level
+    uint n_pages = 0;
+    for (uint level = 0; level < m_sparse_levels; ++level) {
+      eig::Array2u size  = (info.size / (1u << level)).max(1u);
+      eig::Array2u pages = (size + m_page_size - 1) / m_page_size;
+      m_levels.push_back({ .size = size, .pages = pages, .offset = n_pages });
+      n_pages += pages.prod();
+    }
+    m_pages.resize(n_pages);
+    m_page_table_data.resize(n_pages, 0);
+
+    // Feedback is cleared by the GPU, and read back through a persistent mapping
+    auto [feedback, feedback_map] = gl::Buffer::make_readable_span<uint>(std::max(n_pages, 1u));
+    m_feedback     = std::move(feedback);
+    m_feedback_map = feedback_map;
+    m_feedback.clear();
+
+    m_page_table = {{ .size  = std::max(n_pages, 1u) * sizeof(uint),
+                      .flags = BufferCreateFlags::eStorageDynamic }};
+    m_page_table.clear();
+
+    // Mip tail is committed and loaded as a whole, and never evicted
+    detail::with_unpack_alignment_1([&] {
+      for (uint level = m_sparse_levels; level < info.levels; ++level) {
+        eig::Array2u size = (info.size / (1u << level)).max(1u);
+        m_texture.commit(true, level, size);
+        m_page_data.resize(size.prod() * C);
+        m_info.loader(level, eig::Array2u(0), size, m_page_data);
+        m_texture.set(std::span<const T>(m_page_data), level, size);
+      }
+    });
+  }
+
+  template <typename T, uint C>
+  std::pair<uint, eig::Array2u> VirtualTexture<T, C>::page_coord(uint page) const {
+    // Find last level starting at or before page
+    auto it = std::upper_bound(range_iter(m_levels), page,
+      [](uint page, const LevelData &l) { return page < l.offset; });
+    uint level = static_cast<uint>(std::distance(m_levels.begin(), it)) - 1;
+
+    const auto &l = m_levels[level];
+    uint i = page - l.offset;
+    return { level, eig::Array2u(i % l.pages.x(), i / l.pages.x()) };
+  }
+
+  template <typename T, uint C>
+  std::pair<eig::Array2u, eig::Array2u> VirtualTexture<T, C>::page_region(uint level, eig::Array2u coord) const {
+    // Edge pages are clamped to the level's extent
+    eig::Array2u offset = coord * m_page_size;
+    eig::Array2u size   = m_page_size.min(m_levels[level].size - offset);
+    return { offset, size };
+  }
+
+  template <typename T, uint C>
+  bool VirtualTexture<T, C>::load(uint page) {
+    gl_trace();
+    auto [level, coord] = page_coord(page);
+    auto [offset, size] = page_region(level, coord);
+
+    // Skip loading and committing if the staging ring is full; the page is requested again later
+    size_t page_bytes = static_cast<size_t>(size.prod()) * C * sizeof(T);
+    guard(m_streamer.can_stage(page_bytes), false);
+
+    m_page_data.resize(size.prod() * C);
+    m_info.loader(level, offset, size, m_page_data);
+
+    m_texture.commit(true, level, size, offset);
+    if (!m_streamer.set(m_texture, std::span<const T>(m_page_data), level, size, offset)) {
+      m_texture.commit(false, level, size, offset);
+      return false;
+    }
+
+    m_pages[page].is_resident = true;
+    m_page_table_data[page]   = 1;
+    m_resident_size          += m_page_size.prod() * C * sizeof(T);
+    return true;
+  }
+
+  template <typename T, uint C>
+  bool VirtualTexture<T, C>::evict() {
+    gl_trace();
+
+    // Find least-recently requested resident page, skipping those requested this frame
+    uint page = n_pages();
+    for (uint i = 0; i < n_pages(); ++i) {
+      const auto &p = m_pages[i];
+      if (!p.is_resident || p.last_used >= m_frame)
+        continue;
+      if (page == n_pages() || p.last_used < m_pages[page].last_used)
+        page = i;
+    }
+    guard(page < n_pages(), false);
+
+    auto [level, coord] = page_coord(page);
+    auto [offset, size] = page_region(level, coord);
+    m_texture.commit(false, level, size, offset);
+
+    m_pages[page].is_resident = false;
+    m_page_table_data[page]   = 0;
+    m_resident_size          -= m_page_size.prod() * C * sizeof(T);
+    return true;
+  }
+
+  template <typename T, uint C>
+  void VirtualTexture<T, C>::update() {
+    gl_trace_full();
+    debug::check_expr(is_init(), "attempt to use an uninitialized object");
+    guard(!m_pages.empty());
+
+    // Fence feedback written by submitted passes; once signalled, read it and clear for reuse
+    std::vector<uint> requested;
+    if (!m_feedback_fence.is_init()) {
+      sync::memory_barrier(BarrierFlags::eClientMappedBuffer);
+      m_feedback_fence = sync::Fence(sync::time_ns(0));
+    } else if (m_feedback_fence.is_signalled()) {
+      for (uint i = 0; i < n_pages(); ++i)
+        if (m_feedback_map[i])
+          requested.push_back(i);
+      m_feedback.clear();
+      m_feedback_fence = { };
+    }
+
+    // Refresh recency of requested pages, resident or not
+    for (uint page : requested)
+      m_pages[page].last_used = m_frame;
+
+    // Load missing pages coarse levels first, as these back finer levels when sampling;
+    // coarser levels are laid out after finer ones
+    std::erase_if(requested, [&](uint page) { return m_pages[page].is_resident; });
+    std::reverse(range_iter(requested));
+    if (requested.size() > m_info.max_pages_per_update)
+      requested.resize(m_info.max_pages_per_update);
+
+    bool is_dirty = false;
+    size_t page_bytes = m_page_size.prod() * C * sizeof(T);
+    for (uint page : requested) {
+      // Make room within budget; stop if only pages requested this frame remain
+      bool is_budgeted = true;
+      while (m_resident_size + page_bytes > m_info.max_resident_size && (is_budgeted = evict()))
+        is_dirty = true;
+      guard_break(is_budgeted);
+
+      // Stop if staging ring is full; remaining pages are requested again later
+      guard_break(load(page));
+      is_dirty = true;
+    }
+
+    if (is_dirty)
+      m_page_table.set(std::as_bytes(std::span(m_page_table_data)));
+
+    m_frame++;
+  }
+
+  /* Explicit template instantiations of gl::VirtualTexture<...> */
+
+  #define gl_explicit_virtual_texture_components_124(type)\
+    template class VirtualTexture<type, 1>;\
+    template class VirtualTexture<type, 2>;\
+    template class VirtualTexture<type, 4>;
+  gl_explicit_virtual_texture_components_124(ushort)
+  gl_explicit_virtual_texture_components_124(short)
+  gl_explicit_virtual_texture_components_124(uint)
+  gl_explicit_virtual_texture_components_124(int)
+  gl_explicit_virtual_texture_components_124(float)
+} // namespace gl